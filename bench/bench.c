@@ -0,0 +1,73 @@
+#include "bench.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "util.h"
+#include "gl_stub.h"
+
+typedef struct bench {
+    const char *name;
+    void       (*run)(void);
+} bench;
+
+static const bench benches[] = {
+    {"hmap",     bench_hmap},
+    {"generate", bench_generate},
+    {"remesh",   bench_remesh},
+    {"frustum",  bench_frustum},
+    {"ray_cast", bench_ray_cast},
+    {"render",   bench_render},
+    {"edit",     bench_edit},
+    {"noise",    bench_noise},
+};
+
+static bool json = false;
+static size_t reported = 0;
+
+void bench_report(const char *name, const char *variant, size_t ops, double seconds)
+{
+    double ns_per_op = seconds * 1e9 / ops;
+    if (json) {
+        printf("%s\n  {\"benchmark\": \"%s\", \"variant\": \"%s\", \"ops\": %zu, \"seconds\": %.6f, \"ns_per_op\": %.2f}", 
+               reported == 0 ? "" : ",", name, variant, ops, seconds, ns_per_op);
+    } else {
+        printf("%s,%s,%zu,%.6f,%.2f\n", name, variant, ops, seconds, ns_per_op);
+    }
+    fflush(stdout);
+    reported++;
+}
+
+/*
+ * Usage: bench [--json] [benchmark...]
+ * Runs the named benchmarks, or all of them.
+ */
+int main(int argc, char **argv)
+{
+    bool selected[ARRAY_SIZE(benches)] = {false};
+    bool any_selected = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+            continue;
+        }
+        bool found = false;
+        for (size_t j = 0; j < ARRAY_SIZE(benches); j++) {
+            if (strcmp(argv[i], benches[j].name) == 0) {
+                selected[j] = found = any_selected = true;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "unknown benchmark %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    gl_stub_init();
+    printf(json ? "[" : "benchmark,variant,ops,seconds,ns_per_op\n");
+    for (size_t i = 0; i < ARRAY_SIZE(benches); i++) {
+        if (any_selected && !selected[i]) continue;
+        benches[i].run();
+    }
+    if (json) printf("\n]\n");
+    return 0;
+}
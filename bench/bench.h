@@ -0,0 +1,23 @@
+/*
+ * Headless benchmarks, built and run by `make bench`.
+ * GL calls are stubbed out (see src/gl_stub.h), so everything up to issuing GL calls runs as in the game.
+ * Each benchmark reports its results through bench_report, printed as CSV or JSON for tracking regressions.
+ */
+#pragma once
+
+#include <stddef.h>
+
+// seconds benchmarks loop for at least, to even out noise
+#define BENCH_MIN_SECONDS 0.5
+
+// ops done in seconds, variant further qualifies name (e.g. the input pattern)
+void bench_report(const char *name, const char *variant, size_t ops, double seconds);
+
+void bench_hmap(void);
+void bench_generate(void);
+void bench_remesh(void);
+void bench_frustum(void);
+void bench_ray_cast(void);
+void bench_render(void);
+void bench_edit(void);
+void bench_noise(void);
@@ -0,0 +1,52 @@
+#include "bench.h"
+#include <stdlib.h>
+#include "camera.h"
+#include "pos.h"
+#include "util.h"
+
+#define SECTIONS 4096
+
+// culls sections scattered around the camera, by transforming their corners to view space and in world space
+void bench_frustum(void)
+{
+    mat4 proj_matrix;
+    mat4_init_perspective(&proj_matrix, rad_from_deg(100), 1024.0 / 800.0, 0.1, 1000);
+    camera c;
+    camera_init_custom(&c, &proj_matrix, &(vec3){0, 64, 0}, 0, 0);
+    plane view_planes[6];
+    frustum_extract_planes(&view_planes, &proj_matrix);
+
+    static vec3 origins[SECTIONS];
+    srand(1);
+    for (int i = 0; i < SECTIONS; i++) {
+        origins[i] = (vec3){rand() % 512 - 256, rand() % CHUNK_HEIGHT, rand() % 512 - 256};
+    }
+
+    size_t ops = 0;
+    size_t outside = 0;
+    double start = time_seconds();
+    do {
+        for (int i = 0; i < SECTIONS; i++) {
+            mat4 model_matrix, mv_matrix;
+            mat4_init_translation(&model_matrix, origins[i].x, origins[i].y, origins[i].z);
+            mat4_mul(&mv_matrix, &c.view_matrix, &model_matrix);
+            AABB aabb = {{0, 0, 0}, {CHUNK_SIDE, CHUNK_SEC_HEIGHT, CHUNK_SIDE}};
+            outside += AABB_outside_frustum(&aabb, &view_planes, &mv_matrix);
+        }
+        ops += SECTIONS;
+    } while (time_seconds() - start < BENCH_MIN_SECONDS);
+    bench_report("AABB_outside_frustum", "section", ops, time_seconds() - start);
+
+    ops = 0;
+    start = time_seconds();
+    do {
+        for (int i = 0; i < SECTIONS; i++) {
+            vec3 max = {origins[i].x + CHUNK_SIDE, origins[i].y + CHUNK_SEC_HEIGHT, origins[i].z + CHUNK_SIDE};
+            AABB aabb = {origins[i], max};
+            outside += AABB_test_frustum(&aabb, &c.frustum_planes) == FRUSTUM_OUTSIDE;
+        }
+        ops += SECTIONS;
+    } while (time_seconds() - start < BENCH_MIN_SECONDS);
+    bench_report("AABB_test_frustum", "section", ops, time_seconds() - start);
+    (void)outside;
+}
@@ -0,0 +1,114 @@
+/*
+ * Compares the chained hmap against the open addressing ohmap on the world's access patterns:
+ * random lookups of loaded chunks, lookups past the loaded area (neighbour checks at the edges), 
+ * coherent lookups as done by world_get_block during ray casts, where consecutive blocks mostly fall in 
+ * the same chunk, and streaming, which inserts a ring of chunks and evicts another.
+ * Values are chunk pointers in both maps, as the world holds them.
+ */
+#include "bench.h"
+#include <stdio.h>
+#include "pos.h"
+#include "util.h"
+#include "containers/hmap.h"
+#include "containers/ohmap.h"
+
+// stands in for the world's chunk pointers, under another name to not clash with world.c
+typedef void *value_ptr;
+
+HMAP_DECLARE(cpos, value_ptr)
+HMAP_DEFINE(cpos, value_ptr, cpos_hash, cpos_eq)
+OHMAP_DECLARE(cpos, value_ptr)
+OHMAP_DEFINE(cpos, value_ptr, cpos_hash, cpos_eq)
+
+#define LOOKUPS      10000000
+#define STREAM_STEPS 2000
+
+// xorshift, so both maps see the same key sequence
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static cpos random_cpos(uint32_t *state, int32_t radius)
+{
+    int32_t side = 2 * radius + 1;
+    return (cpos){(int32_t)(next_random(state) % side) - radius, (int32_t)(next_random(state) % side) - radius};
+}
+
+/*
+ * Defines bench_<map>_cpos(radius) which loads every chunk within radius of the origin, then times hits, misses, 
+ * coherent hits and walking the loaded square STREAM_STEPS chunks east.
+ */
+#define BENCH_DEFINE(map) \
+static void bench_##map##_cpos(int32_t radius)\
+{\
+    map##_cpos_value_ptr h;\
+    map##_cpos_value_ptr_init(&h, NULL, NULL);\
+    for (int32_t x = -radius; x <= radius; x++) {\
+        for (int32_t z = -radius; z <= radius; z++) {\
+            *map##_cpos_value_ptr_put(&h, &(cpos){x, z}) = &h;\
+        }\
+    }\
+    char variant[32];\
+    snprintf(variant, sizeof(variant), "%s/%u", #map, h.len);\
+\
+    uint32_t state = 2463534242u;\
+    size_t found = 0;\
+    double start = time_seconds();\
+    for (int i = 0; i < LOOKUPS; i++) {\
+        cpos cp = random_cpos(&state, radius);\
+        found += map##_cpos_value_ptr_get(&h, &cp) != NULL;\
+    }\
+    bench_report("hmap_hit", variant, LOOKUPS, time_seconds() - start);\
+\
+    start = time_seconds();\
+    for (int i = 0; i < LOOKUPS; i++) {\
+        cpos cp = random_cpos(&state, radius);\
+        cp.x += 2 * radius + 1;\
+        found += map##_cpos_value_ptr_get(&h, &cp) != NULL;\
+    }\
+    bench_report("hmap_miss", variant, LOOKUPS, time_seconds() - start);\
+\
+    cpos walk = {0, 0};\
+    start = time_seconds();\
+    for (int i = 0; i < LOOKUPS; i++) {\
+        if (i % 16 == 0) {\
+            uint32_t r = next_random(&state);\
+            walk.x += r & 1 ? 1 : -1;\
+            walk.z += r & 2 ? 1 : -1;\
+            if (walk.x < -radius || walk.x > radius) walk.x = 0;\
+            if (walk.z < -radius || walk.z > radius) walk.z = 0;\
+        }\
+        found += map##_cpos_value_ptr_get(&h, &walk) != NULL;\
+    }\
+    bench_report("hmap_coherent", variant, LOOKUPS, time_seconds() - start);\
+\
+    start = time_seconds();\
+    for (int32_t step = 1; step <= STREAM_STEPS; step++) {\
+        for (int32_t z = -radius; z <= radius; z++) {\
+            *map##_cpos_value_ptr_put(&h, &(cpos){step + radius, z}) = &h;\
+            map##_cpos_value_ptr_remove(&h, &(cpos){step - radius - 1, z});\
+        }\
+    }\
+    bench_report("hmap_stream", variant, STREAM_STEPS * (2 * radius + 1), time_seconds() - start);\
+\
+    if (found != 2 * LOOKUPS) fprintf(stderr, "unexpected lookup results\n");\
+    map##_cpos_value_ptr_destroy(&h);\
+}
+
+BENCH_DEFINE(hmap)
+BENCH_DEFINE(ohmap)
+
+void bench_hmap(void)
+{
+    // the default view distance, and a map far larger than the caches
+    int32_t radii[] = {16, 128};
+    for (size_t i = 0; i < ARRAY_SIZE(radii); i++) {
+        bench_hmap_cpos(radii[i]);
+        bench_ohmap_cpos(radii[i]);
+    }
+}
@@ -0,0 +1,94 @@
+#include "bench.h"
+#include <stdio.h>
+#include "world.h"
+#include "util.h"
+
+typedef enum pattern {
+    PATTERN_EMPTY,
+    PATTERN_FULL,
+    // alternating blocks and air, the most faces a section can have
+    PATTERN_CHECKERBOARD,
+    // the section with the terrain's surface in a generated world
+    PATTERN_TERRAIN,
+
+    PATTERNS_COUNT,
+} pattern;
+
+static const char *pattern_names[PATTERNS_COUNT] = {"empty", "full", "checkerboard", "terrain"};
+
+static void fill_pattern(chunk *c, pattern p)
+{
+    uint8_t data[CHUNK_SEC_HEIGHT][CHUNK_SIDE][CHUNK_SIDE];
+    for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            for (int x = 0; x < CHUNK_SIDE; x++) {
+                switch (p) {
+                case PATTERN_EMPTY:        data[y][z][x] = BLOCK_AIR; break;
+                case PATTERN_FULL:         data[y][z][x] = BLOCK_COBBLESTONE; break;
+                case PATTERN_CHECKERBOARD: data[y][z][x] = (x + y + z) % 2 == 0 ? BLOCK_COBBLESTONE : BLOCK_AIR; break;
+                default: unreachable();
+                }
+            }
+        }
+    }
+    for (int sec = 0; sec < CHUNK_SEC_COUNT; sec++) {
+        chunk_set_sec_blocks(c, sec, (const uint8_t (*)[CHUNK_SEC_SIZE])data);
+    }
+}
+
+// times snapshotting and meshing the section, everything chunk_remesh_sec does except uploading, with and without
+// working out which faces see each other
+static void bench_remesh_sec(const chunk *c, int sec, const chunk *(*dir_chunks)[4], pattern p)
+{
+    for (chunk_mesher mesher = 0; mesher < CHUNK_MESHERS_COUNT; mesher++) {
+        for (int sees = 0; sees < 2; sees++) {
+            chunk_sec_snapshot snap;
+            chunk_mesh m;
+            chunk_mesh_init(&m);
+            size_t ops = 0;
+            double start = time_seconds();
+            do {
+                for (int i = 0; i < 100; i++) {
+                    chunk_snapshot_sec(c, sec, dir_chunks, &snap);
+                    chunk_mesh_build(&m, &snap, mesher, sees);
+                }
+                ops += 100;
+            } while (time_seconds() - start < BENCH_MIN_SECONDS);
+            double seconds = time_seconds() - start;
+
+            char variant[64];
+            snprintf(variant, sizeof(variant), "%s/%s%s", pattern_names[p], chunk_mesher_name(mesher), 
+                     sees ? "/sees" : "");
+            bench_report("chunk_sec_remesh", variant, ops, seconds);
+            chunk_mesh_destroy(&m);
+        }
+    }
+}
+
+void bench_remesh(void)
+{
+    chunk c;
+    chunk_init(&c);
+    // the chunk is its own neighbour on every side, so the borders follow the pattern
+    const chunk *dir_chunks[4] = {&c, &c, &c, &c};
+    for (pattern p = 0; p < PATTERN_TERRAIN; p++) {
+        fill_pattern(&c, p);
+        bench_remesh_sec(&c, CHUNK_SEC_COUNT / 2, &dir_chunks, p);
+    }
+    chunk_destroy(&c);
+
+    world w;
+    world_init(&w);
+    world_set_load_radius(&w, 1);
+    world_generate(&w);
+    cpos origin = {0, 0};
+    const chunk *terrain = *hmap_cpos_chunk_ptr_get(&w.chunks, &origin);
+    for (dir d = DIR_NORTH; d <= DIR_WEST; d++) {
+        cpos cp = cpos_offset(origin, d);
+        dir_chunks[d] = *hmap_cpos_chunk_ptr_get(&w.chunks, &cp);
+    }
+    int surface = 0;
+    while (chunk_get_block(terrain, (cbpos){CHUNK_SIDE / 2, surface + 1, CHUNK_SIDE / 2}) != BLOCK_AIR) surface++;
+    bench_remesh_sec(terrain, surface / CHUNK_SEC_HEIGHT, &dir_chunks, PATTERN_TERRAIN);
+    world_destroy(&w);
+}
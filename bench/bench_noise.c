@@ -0,0 +1,52 @@
+#include "bench.h"
+#include <string.h>
+#include "perlin/noise1234.h"
+#include "pos.h"
+#include "util.h"
+
+#define COLUMNS (CHUNK_SIDE * CHUNK_SIDE)
+#define CHUNKS  64
+
+// evaluates the terrain's noise for the columns of a row of chunks, a point at a time and in batches
+void bench_noise(void)
+{
+    static float xs[CHUNKS][COLUMNS], zs[CHUNKS][COLUMNS], scalar[CHUNKS][COLUMNS], batch[CHUNKS][COLUMNS];
+    for (int c = 0; c < CHUNKS; c++) {
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            for (int x = 0; x < CHUNK_SIDE; x++) {
+                // as terrain_build_heightmap samples its first octave, from the chunks at -32 to 31
+                xs[c][z * CHUNK_SIDE + x] = ((c - CHUNKS / 2) * CHUNK_SIDE + x) * 0.01;
+                zs[c][z * CHUNK_SIDE + x] = (c * 7 * CHUNK_SIDE + z) * 0.01;
+            }
+        }
+    }
+    for (int c = 0; c < CHUNKS; c++) {
+        for (int i = 0; i < COLUMNS; i++) {
+            scalar[c][i] = noise2(xs[c][i], zs[c][i]);
+        }
+        noise2_batch(xs[c], zs[c], batch[c], COLUMNS);
+    }
+    if (memcmp(scalar, batch, sizeof(scalar)) != 0) panic("%s", "noise2_batch differs from noise2");
+
+    size_t ops = 0;
+    double start = time_seconds();
+    do {
+        for (int c = 0; c < CHUNKS; c++) {
+            for (int i = 0; i < COLUMNS; i++) {
+                scalar[c][i] = noise2(xs[c][i], zs[c][i]);
+            }
+        }
+        ops += CHUNKS * COLUMNS;
+    } while (time_seconds() - start < BENCH_MIN_SECONDS);
+    bench_report("noise2", "scalar", ops, time_seconds() - start);
+
+    ops = 0;
+    start = time_seconds();
+    do {
+        for (int c = 0; c < CHUNKS; c++) {
+            noise2_batch(xs[c], zs[c], batch[c], COLUMNS);
+        }
+        ops += CHUNKS * COLUMNS;
+    } while (time_seconds() - start < BENCH_MIN_SECONDS);
+    bench_report("noise2", "batch", ops, time_seconds() - start);
+}
@@ -0,0 +1,224 @@
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include "world.h"
+#include "util.h"
+
+/*
+ * Generates the world with 1, 2, 4... workers up to one per core, as the GL thread only waits meanwhile.
+ * ops are chunks, so chunks per second is ops / seconds.
+ */
+void bench_generate(void)
+{
+    size_t cores = sysconf(_SC_NPROCESSORS_ONLN);
+    for (size_t threads = 1; ; threads = threads * 2 < cores ? threads * 2 : cores) {
+        world w;
+        world_init(&w);
+        worker_pool_destroy(&w.workers);
+        worker_pool_init(&w.workers, threads);
+        char variant[32];
+        double start = time_seconds();
+        world_generate(&w);
+        double generated = time_seconds();
+        snprintf(variant, sizeof(variant), "terrain %zu threads", threads);
+        bench_report("world_generate", variant, w.chunks.len, generated - start);
+        // stage times are summed over the threads, so they're per chunk on one thread
+        terrain_stats stats = terrain_get_stats(&w.terrain);
+        for (int s = 0; s < TERRAIN_STAGES_COUNT; s++) {
+            snprintf(variant, sizeof(variant), "%s %zu threads", terrain_stage_names[s], threads);
+            bench_report("terrain_generate", variant, stats.chunks, stats.seconds[s]);
+        }
+        while (w.meshes_pending > 0) {
+            world_upload_meshes(&w);
+        }
+        snprintf(variant, sizeof(variant), "meshed %zu threads", threads);
+        bench_report("world_generate", variant, w.chunks.len, time_seconds() - start);
+        world_destroy(&w);
+        if (threads >= cores) break;
+    }
+}
+
+void bench_ray_cast(void)
+{
+    world w;
+    world_init(&w);
+    world_set_load_radius(&w, 4);
+    world_generate(&w);
+    while (w.meshes_pending > 0) {
+        world_upload_meshes(&w);
+    }
+
+    mat4 proj_matrix;
+    mat4_init_perspective(&proj_matrix, rad_from_deg(100), 1024.0 / 800.0, 0.1, 1000);
+    camera c;
+    camera_init_custom(&c, &proj_matrix, &(vec3){8, 110, 8}, 0, 0);
+    vec3 dirs[1024];
+    srand(1);
+    for (size_t i = 0; i < ARRAY_SIZE(dirs); i++) {
+        camera_set_yaw_pitch(&c, rand() % 360 - 180.0f, rand() % 180 - 90.0f);
+        dirs[i] = c.dir;
+    }
+
+    // the game casts 6 blocks to pick the selected block, long casts cross chunks
+    uint8_t distances[] = {6, 64};
+    for (size_t i = 0; i < ARRAY_SIZE(distances); i++) {
+        size_t ops = 0;
+        double start = time_seconds();
+        do {
+            for (size_t j = 0; j < ARRAY_SIZE(dirs); j++) {
+                c.dir = dirs[j];
+                block_type b;
+                world_ray_cast(&w, &c, distances[i], &b);
+            }
+            ops += ARRAY_SIZE(dirs);
+        } while (time_seconds() - start < BENCH_MIN_SECONDS);
+        char variant[32];
+        snprintf(variant, sizeof(variant), "%u blocks", distances[i]);
+        bench_report("world_ray_cast", variant, ops, time_seconds() - start);
+    }
+    world_destroy(&w);
+}
+
+/*
+ * Blows holes of radius 4 into the ground where sections and chunks meet, flushing the edits after every block 
+ * or once per hole, and times the edits together with remeshing the sections they touch. 
+ * Each variant edits a freshly generated world.
+ */
+void bench_edit(void)
+{
+    const int radius = 4;
+    for (int per_tick = 0; per_tick < 2; per_tick++) {
+        world w;
+        world_init(&w);
+        world_set_load_radius(&w, 4);
+        world_generate(&w);
+        while (w.meshes_pending > 0) {
+            world_upload_meshes(&w);
+        }
+
+        size_t edits = 0, remeshes = 0;
+        double start = time_seconds();
+        for (int32_t hole = 0; hole < 16; hole++) {
+            int32_t cx = hole % 4 * 16 - 32, cz = hole / 4 * 16 - 32, cy = 48;
+            for (int32_t x = -radius; x <= radius; x++) {
+                for (int32_t y = -radius; y <= radius; y++) {
+                    for (int32_t z = -radius; z <= radius; z++) {
+                        if (x*x + y*y + z*z > radius*radius) continue;
+                        world_setr_block(&w, (bpos){cx + x, cy + y, cz + z}, BLOCK_AIR);
+                        edits++;
+                        if (!per_tick) remeshes += world_flush_edits(&w);
+                    }
+                }
+            }
+            if (per_tick) remeshes += world_flush_edits(&w);
+        }
+        while (w.meshes_pending > 0) {
+            world_upload_meshes(&w);
+        }
+        char variant[64];
+        snprintf(variant, sizeof(variant), "flush per %s (%zu remeshes)", per_tick ? "hole" : "block", remeshes);
+        bench_report("world_setr_block", variant, edits, time_seconds() - start);
+        world_destroy(&w);
+    }
+}
+
+/*
+ * Culls every section with a mesh one at a time and in batches, reporting sections per op.
+ * Both have to find the same sections in view from each of the views first.
+ */
+static void bench_cull_sections(world *w, camera *c, const float (*views)[2], size_t views_count)
+{
+    HMAP_ITER_BEGIN(&w->chunks, e)
+        chunk_add_sec_bounds(e->value, e->key, &w->cull_bounds, &w->cull_meshes);
+    HMAP_ITER_END
+    const AABB_soa *s = &w->cull_bounds;
+    AABB *bounds = malloc(s->len * sizeof(*bounds));
+    for (size_t i = 0; i < s->len; i++) {
+        bounds[i] = (AABB){{s->min_x[i], s->min_y[i], s->min_z[i]}, {s->max_x[i], s->max_y[i], s->max_z[i]}};
+    }
+    uint64_t *visible = malloc((s->len + 63) / 64 * sizeof(*visible));
+
+    size_t visible_scalar = 0, visible_batch = 0;
+    for (size_t v = 0; v < views_count; v++) {
+        camera_set_yaw_pitch(c, views[v][0], views[v][1]);
+        camera_update_view_matrix(c);
+        for (size_t i = 0; i < s->len; i++) {
+            visible_scalar += AABB_test_frustum(&bounds[i], &c->frustum_planes) != FRUSTUM_OUTSIDE;
+        }
+        AABB_soa_test_frustum(s, &c->frustum_planes, visible);
+        for (size_t i = 0; i < (s->len + 63) / 64; i++) {
+            visible_batch += __builtin_popcountll(visible[i]);
+        }
+    }
+    if (visible_scalar != visible_batch) panic("batch culling found %zu sections in view, not %zu", visible_batch, visible_scalar);
+
+    char variant[32];
+    size_t ops = 0;
+    size_t outside = 0;
+    double start = time_seconds();
+    do {
+        for (size_t i = 0; i < s->len; i++) {
+            outside += AABB_test_frustum(&bounds[i], &c->frustum_planes) == FRUSTUM_OUTSIDE;
+        }
+        ops += s->len;
+    } while (time_seconds() - start < BENCH_MIN_SECONDS);
+    bench_report("section cull", "scalar", ops, time_seconds() - start);
+
+    ops = 0;
+    start = time_seconds();
+    do {
+        AABB_soa_test_frustum(s, &c->frustum_planes, visible);
+        outside += visible[0] & 1;
+        ops += s->len;
+    } while (time_seconds() - start < BENCH_MIN_SECONDS);
+    snprintf(variant, sizeof(variant), "%d wide", AABB_BATCH_WIDTH);
+    bench_report("section cull", variant, ops, time_seconds() - start);
+    (void)outside;
+
+    free(bounds);
+    free(visible);
+    AABB_soa_clear(&w->cull_bounds);
+    list_mesh_alloc_ptr_clear(&w->cull_meshes);
+}
+
+// culls and queues the sections of a world at full view distance, looking around from its center
+void bench_render(void)
+{
+    world w;
+    world_init(&w);
+    world_generate(&w);
+    while (w.meshes_pending > 0) {
+        world_upload_meshes(&w);
+    }
+    shader_chunk shader;
+    shader_chunk_init(&shader);
+
+    mat4 proj_matrix;
+    mat4_init_perspective(&proj_matrix, rad_from_deg(100), 1024.0 / 800.0, 0.1, 1000);
+    camera c;
+    camera_init_custom(&c, &proj_matrix, &(vec3){8, 80, 8}, 0, 0);
+    const float views[][2] = {{0, 0}, {90, -20}, {180, 10}, {-90, -60}};
+
+    for (int cave_culling = 0; cave_culling < 2; cave_culling++) {
+        world_set_cave_culling(&w, cave_culling);
+        // turning it on remeshes the world
+        while (w.meshes_pending > 0) {
+            world_upload_meshes(&w);
+        }
+        size_t ops = 0;
+        double start = time_seconds();
+        do {
+            for (size_t i = 0; i < ARRAY_SIZE(views); i++) {
+                camera_set_yaw_pitch(&c, views[i][0], views[i][1]);
+                camera_update_view_matrix(&c);
+                world_render(&w, &c, &shader);
+            }
+            ops += ARRAY_SIZE(views);
+        } while (time_seconds() - start < BENCH_MIN_SECONDS);
+        bench_report("world_render", cave_culling ? "cave culling" : "frustum only", ops, time_seconds() - start);
+    }
+    bench_cull_sections(&w, &c, views, ARRAY_SIZE(views));
+    world_destroy(&w);
+}
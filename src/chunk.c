@@ -1,252 +1,828 @@
-#include "chunk.h"
-#include <stdlib.h>
-#include <assert.h>
-#include <stdbool.h>
-#include "util.h"
-#include "containers/gl_list.h"
-#include <memory.h>
-
-static void chunk_sec_init(chunk_sec *cs)
-{
-    glGenVertexArrays(1, &cs->vao);
-    glBindVertexArray(cs->vao);
-    glGenBuffers(1, &cs->vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, cs->vbo);
-    glGenBuffers(1, &cs->ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cs->ebo);
-    shader_block_set_up_attributes();
-    memset(cs->data, BLOCK_AIR, CHUNK_SEC_SIZE);
-    cs->index_count = 0;
-    cs->block_count = 0;
-}
-
-static block_type chunk_sec_get_block(const chunk_sec *cs, csbpos pos) 
-{
-    return cs->data[pos.y][pos.z][pos.x];
-}
-
-/*
- * Returned integer has (1 << dir) set if modifying block in pos would affect the 
- * chunk sec in that dir (As in need remeshing).
- */
-uint8_t chunk_sec_get_block_affected(csbpos pos) 
-{
-    uint8_t ret = 0;
-    if      (pos.z == 0)                  ret |= (1 << DIR_NORTH);
-    else if (pos.z == CHUNK_SIDE-1)       ret |= (1 << DIR_SOUTH);
-    if      (pos.x == CHUNK_SIDE-1)       ret |= (1 << DIR_EAST);
-    else if (pos.x == 0)                  ret |= (1 << DIR_WEST);
-    if      (pos.y == CHUNK_SEC_HEIGHT-1) ret |= (1 << DIR_UP);
-    else if (pos.y == 0)                  ret |= (1 << DIR_DOWN);
-    return ret;
-}
-
-static void chunk_sec_set_block(chunk_sec *cs, csbpos pos, block_type b)
-{
-    block_type prev = chunk_sec_get_block(cs, pos);
-    cs->data[pos.y][pos.z][pos.x] = b;
-    if (prev == BLOCK_AIR && b != BLOCK_AIR) {
-        cs->block_count++;
-    } else if (b == BLOCK_AIR && prev != BLOCK_AIR) {
-        cs->block_count--;
-    }
-}
-
-static void chunk_sec_destroy(chunk_sec *cs)
-{
-    glDeleteVertexArrays(1, &cs->vao);
-    glDeleteBuffers(1, &cs->vbo);
-    glDeleteBuffers(1, &cs->ebo);
-}
-
-static bool chunk_sec_get_next_block(
-    const chunk_sec *cs, 
-    csbpos          csbp, 
-    dir             dir, 
-    const chunk_sec *(*dir_secs)[DIRS_COUNT], 
-    block_type      *ret)
-{
-    csbpos new_csbp = csbpos_offset(csbp, dir);
-    bool from_dir = false;
-    switch (dir) {
-    case DIR_NORTH: if (csbp.z == 0)                  { from_dir = true; } break;
-    case DIR_SOUTH: if (csbp.z == CHUNK_SIDE-1)       { from_dir = true; } break;
-    case DIR_EAST:  if (csbp.x == CHUNK_SIDE-1)       { from_dir = true; } break;
-    case DIR_WEST:  if (csbp.x == 0)                  { from_dir = true; } break;
-    case DIR_UP:    if (csbp.y == CHUNK_SEC_HEIGHT-1) { from_dir = true; } break;
-    case DIR_DOWN:  if (csbp.y == 0)                  { from_dir = true; } break;
-    default:
-        unreachable();
-        return (block_type) {0};
-    }
-
-    if (from_dir) {
-        cs = (*dir_secs)[dir];
-        if (cs == NULL) {
-            if (dir == DIR_UP || dir == DIR_DOWN) {
-                *ret = BLOCK_AIR;
-                return true;
-            }
-            return false;
-        }
-    } 
-    *ret = chunk_sec_get_block(cs, new_csbp);
-    return true;
-}
-
-static void chunk_sec_remesh(chunk_sec *cs, const chunk_sec * (*dir_secs)[DIRS_COUNT])
-{
-    static shader_block_vertex vertex_list[CHUNK_SEC_SIZE * BLOCK_VERTICES_COUNT];
-    static GLuint index_list[CHUNK_SEC_SIZE * BLOCK_INDICES_COUNT];
-
-    size_t vertex_list_index = 0;
-    size_t index_list_index = 0;
-    size_t faces_added = 0; 
-
-    for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
-        for (int z = 0; z < CHUNK_SIDE; z++) {
-            for (int x = 0; x < CHUNK_SIDE; x++) {
-                csbpos csbp = {x, y, z};
-                block_type b = chunk_sec_get_block(cs, csbp);
-                if (b == BLOCK_AIR) continue;
-
-                block_type next_blocks[DIRS_COUNT];
-                bool next_blocks_present[DIRS_COUNT] = {
-                    chunk_sec_get_next_block(cs, csbp, DIR_NORTH, dir_secs, &next_blocks[DIR_NORTH]),
-                    chunk_sec_get_next_block(cs, csbp, DIR_SOUTH, dir_secs, &next_blocks[DIR_SOUTH]),
-                    chunk_sec_get_next_block(cs, csbp, DIR_EAST, dir_secs, &next_blocks[DIR_EAST]),
-                    chunk_sec_get_next_block(cs, csbp, DIR_WEST, dir_secs, &next_blocks[DIR_WEST]),
-                    chunk_sec_get_next_block(cs, csbp, DIR_UP, dir_secs, &next_blocks[DIR_UP]),
-                    chunk_sec_get_next_block(cs, csbp, DIR_DOWN, dir_secs, &next_blocks[DIR_DOWN]),
-                };
-
-                for (dir face = 0; face < DIRS_COUNT; face++) {
-                    // don't render map edges
-                    if (!next_blocks_present[face]) continue;
-                    // no need to render face sandwiched between two blocks and can't be seen.
-                    if (block_is_opaque(next_blocks[face])) continue;
-                    for (int i = 0; i < BLOCK_FACE_VERTICES_COUNT; i++) {
-                        shader_block_vertex *v = &vertex_list[vertex_list_index++];
-                        *v = block_face_vertices[face][i];
-                        v->pos_x += x;
-                        v->pos_y += y;
-                        v->pos_z += z;
-                        v->uv_s = (v->uv_s + block_atlas_indices[b][face].s) * BLOCK_TEX_SIDE_S; 
-                        v->uv_t = (v->uv_t + block_atlas_indices[b][face].t) * BLOCK_TEX_SIDE_T; 
-                    }
-                    GLuint indices[] = {block_face_indices(faces_added)};
-                    for (GLuint i = 0; i < BLOCK_FACE_INDICES_COUNT; i++) {
-                        index_list[index_list_index++] = indices[i];
-                    }
-                    faces_added++;
-                }
-            }
-        }
-    }
-    
-    cs->index_count = index_list_index;
-    glBindBuffer(GL_ARRAY_BUFFER, cs->vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertex_list_index * sizeof(shader_block_vertex), vertex_list, GL_STATIC_DRAW);
-    glBindVertexArray(cs->vao);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cs->ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_list_index * sizeof(GLuint), index_list, GL_STATIC_DRAW);
-}
-
-void chunk_init(chunk *c) 
-{
-    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
-        chunk_sec_init(&c->secs[i]);
-    }
-}
-
-void chunk_set_block(chunk *c, cbpos pos, block_type b)
-{
-    int section = section_from_cbpos(pos);
-    chunk_sec *cs = &c->secs[section];
-    csbpos p = cbpos_to_csbpos(pos);
-    chunk_sec_set_block(cs, p, b);
-}
-
-uint8_t chunk_setr_block(chunk *c, cbpos pos, block_type b, chunk *(*dir_chunks)[4])
-{
-    int section = section_from_cbpos(pos);
-    chunk_sec *cs = &c->secs[section];
-    csbpos p = cbpos_to_csbpos(pos);
-    chunk_sec_set_block(cs, p, b);
-    chunk_remesh_sec(c, section, (const chunk *(*)[4])dir_chunks);
-
-    uint8_t affected = chunk_sec_get_block_affected(p);
-    if ((affected & (1 << DIR_UP)) != 0) {
-        if (section < CHUNK_SEC_HEIGHT-1) {
-            chunk_remesh_sec(c, section+1, (const chunk *(*)[4])dir_chunks);
-        }
-    }
-    if ((affected & (1 << DIR_DOWN)) != 0) {
-        if (section > 0) {
-            chunk_remesh_sec(c, section-1, (const chunk *(*)[4])dir_chunks);
-        }
-    }
-
-    return affected;
-}
-
-block_type chunk_get_block(const chunk *c, cbpos pos)
-{
-    int section = section_from_cbpos(pos);
-    const chunk_sec *cs = &c->secs[section];
-    csbpos p = cbpos_to_csbpos(pos);
-    return chunk_sec_get_block(cs, p);
-}
-
-void chunk_remesh_sec(chunk *c, int sec, const chunk *(*dir_chunks)[4])
-{
-    chunk_sec *cs = &c->secs[sec];
-    if (cs->block_count == 0) return;
-    const chunk_sec * dir_secs[DIRS_COUNT] = {
-        (*dir_chunks)[DIR_NORTH] == NULL ? NULL : &(*dir_chunks)[DIR_NORTH]->secs[sec], 
-        (*dir_chunks)[DIR_SOUTH] == NULL ? NULL : &(*dir_chunks)[DIR_SOUTH]->secs[sec], 
-        (*dir_chunks)[DIR_EAST] == NULL ? NULL : &(*dir_chunks)[DIR_EAST]->secs[sec], 
-        (*dir_chunks)[DIR_WEST] == NULL ? NULL : &(*dir_chunks)[DIR_WEST]->secs[sec], 
-        sec == CHUNK_SEC_COUNT-1 ? NULL : &c->secs[sec+1], 
-        sec == 0 ? NULL : &c->secs[sec-1], 
-    };
-
-    chunk_sec_remesh(cs, &dir_secs);
-}
-
-void chunk_remesh(chunk *c, const chunk * (*dir_chunks)[4])
-{
-    for (int section = 0; section < CHUNK_SEC_COUNT; section++) {
-        chunk_remesh_sec(c, section, dir_chunks);
-    }
-}
-
-void chunk_render(const chunk *c, cpos pos, const camera *camera, shader_block *shader)
-{
-    for (int section = 0; section < CHUNK_SEC_COUNT; section++) {
-        const chunk_sec *cs = &c->secs[section];
-        if (cs->block_count == 0) continue;
-        mat4 model_matrix;
-        bpos bp = cpos_to_bpos(pos);
-        bp.y += section * CHUNK_SEC_HEIGHT;
-        mat4_init_translation(&model_matrix, bp.x, bp.y, bp.z);
-        mat4 mv_matrix;
-        mat4_mul(&mv_matrix, &camera->view_matrix, &model_matrix);
-
-        AABB aabb = {{0, 0, 0}, {CHUNK_SIDE, CHUNK_SEC_HEIGHT, CHUNK_SIDE}};
-        if (AABB_outside_frustum(&aabb, &camera->frustum_planes, &mv_matrix)) continue;
-
-        mat4 mvp_matrix;
-        mat4_mul(&mvp_matrix, &camera->proj_matrix, &mv_matrix);
-        glUniformMatrix4fv(shader->mvp_matrix_location, 1, GL_FALSE, (float *)mvp_matrix.arr);
-        glBindVertexArray(cs->vao);
-        glDrawElements(GL_TRIANGLES, cs->index_count, GL_UNSIGNED_INT, 0);
-    }
-}
-
-void chunk_destroy(chunk *c)
-{
-    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
-        chunk_sec_destroy(&c->secs[i]);
-    }
+#include "chunk.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <stdbool.h>
+#include "util.h"
+#include <memory.h>
+
+static void chunk_sec_init(chunk_sec *cs)
+{
+    cs->indices = NULL;
+    cs->occupancy = NULL;
+    cs->palette[0] = BLOCK_AIR;
+    cs->palette_len = 1;
+    cs->bits = 0;
+    cs->block_count = 0;
+    mesh_alloc_init(&cs->mesh);
+    cs->mesh_version = 0;
+    // until it's meshed, assume the section hides nothing
+    memset(cs->sees, CHUNK_SEC_SEES_ALL, sizeof(cs->sees));
+    cs->visit_frame = 0;
+}
+
+static size_t chunk_sec_block_index(csbpos pos)
+{
+    return (pos.y * CHUNK_SIDE + pos.z) * CHUNK_SIDE + pos.x;
+}
+
+static size_t chunk_sec_indices_size(uint8_t bits)
+{
+    return CHUNK_SEC_SIZE * bits / 8;
+}
+
+#define CHUNK_SEC_ROWS     (CHUNK_SEC_HEIGHT * CHUNK_SIDE)
+#define CHUNK_SEC_ROW_FULL ((uint16_t)((1u << CHUNK_SIDE) - 1))
+_Static_assert(CHUNK_SIDE == 16, "occupancy rows are 16 bits");
+
+static uint16_t chunk_sec_get_row(const chunk_sec *cs, int y, int z)
+{
+    if (cs->occupancy == NULL) return cs->palette[0] == BLOCK_AIR ? 0 : CHUNK_SEC_ROW_FULL;
+    return cs->occupancy[y * CHUNK_SIDE + z];
+}
+
+static void chunk_sec_set_occupied(chunk_sec *cs, csbpos pos, bool occupied)
+{
+    uint16_t *row = &cs->occupancy[pos.y * CHUNK_SIDE + pos.z];
+    *row = (*row & ~(1u << pos.x)) | (uint16_t)occupied << pos.x;
+}
+
+// rebuilds the occupancy rows from data, in yzx order
+static void chunk_sec_build_occupancy(chunk_sec *cs, const uint8_t (*data)[CHUNK_SEC_SIZE])
+{
+    for (size_t r = 0; r < CHUNK_SEC_ROWS; r++) {
+        const uint8_t *blocks = &(*data)[r * CHUNK_SIDE];
+        uint16_t row = 0;
+        for (int x = 0; x < CHUNK_SIDE; x++) {
+            row |= (uint16_t)(blocks[x] != BLOCK_AIR) << x;
+        }
+        cs->occupancy[r] = row;
+    }
+}
+
+static uint8_t chunk_sec_get_entry(const chunk_sec *cs, size_t i)
+{
+    size_t bit = i * cs->bits;
+    return (cs->indices[bit >> 3] >> (bit & 7)) & ((1 << cs->bits) - 1);
+}
+
+static void chunk_sec_set_entry(chunk_sec *cs, size_t i, uint8_t entry)
+{
+    size_t bit = i * cs->bits;
+    uint8_t mask = ((1 << cs->bits) - 1) << (bit & 7);
+    cs->indices[bit >> 3] = (cs->indices[bit >> 3] & ~mask) | ((entry << (bit & 7)) & mask);
+}
+
+static block_type chunk_sec_get_block(const chunk_sec *cs, csbpos pos) 
+{
+    switch (cs->bits) {
+    case 0:  return cs->palette[0];
+    case 8:  return cs->indices[chunk_sec_block_index(pos)];
+    default: return cs->palette[chunk_sec_get_entry(cs, chunk_sec_block_index(pos))];
+    }
+}
+
+// decodes every block of the section into data, in yzx order
+static void chunk_sec_decode(const chunk_sec *cs, uint8_t (*data)[CHUNK_SEC_SIZE])
+{
+    switch (cs->bits) {
+    case 0: memset(*data, cs->palette[0], CHUNK_SEC_SIZE); break;
+    case 8: memcpy(*data, cs->indices, CHUNK_SEC_SIZE); break;
+    default:
+        for (size_t i = 0; i < CHUNK_SEC_SIZE; i++) {
+            (*data)[i] = cs->palette[chunk_sec_get_entry(cs, i)];
+        }
+        break;
+    }
+}
+
+// repacks the section with entries bits wide, which must be wider than now
+static void chunk_sec_grow(chunk_sec *cs, uint8_t bits)
+{
+    uint8_t data[CHUNK_SEC_SIZE];
+    chunk_sec_decode(cs, &data);
+    if (cs->occupancy == NULL) {
+        uint16_t row = chunk_sec_get_row(cs, 0, 0);
+        cs->occupancy = malloc(CHUNK_SEC_ROWS * sizeof(*cs->occupancy));
+        for (size_t r = 0; r < CHUNK_SEC_ROWS; r++) {
+            cs->occupancy[r] = row;
+        }
+    }
+    free(cs->indices);
+    cs->bits = bits;
+    cs->indices = malloc(chunk_sec_indices_size(bits));
+    if (bits == 8) {
+        memcpy(cs->indices, data, CHUNK_SEC_SIZE);
+        return;
+    }
+    memset(cs->indices, 0, chunk_sec_indices_size(bits));
+    for (size_t i = 0; i < CHUNK_SEC_SIZE; i++) {
+        uint8_t entry = 0;
+        while (cs->palette[entry] != data[i]) entry++;
+        chunk_sec_set_entry(cs, i, entry);
+    }
+}
+
+// returns the palette entry for b, adding it and growing the section if needed
+static uint8_t chunk_sec_palette_entry(chunk_sec *cs, block_type b)
+{
+    // direct sections store block types as they are
+    if (cs->bits == 8) return b;
+    for (uint8_t i = 0; i < cs->palette_len; i++) {
+        if (cs->palette[i] == b) return i;
+    }
+    if (cs->palette_len == CHUNK_SEC_PALETTE_CAP) {
+        chunk_sec_grow(cs, 8);
+        return b;
+    }
+    cs->palette[cs->palette_len++] = b;
+    if (cs->palette_len > (1 << cs->bits)) {
+        chunk_sec_grow(cs, cs->bits == 0 ? 1 : cs->bits * 2);
+    }
+    return cs->palette_len - 1;
+}
+
+static void chunk_sec_reset(chunk_sec *cs, block_type b)
+{
+    free(cs->indices);
+    free(cs->occupancy);
+    cs->indices = NULL;
+    cs->occupancy = NULL;
+    cs->palette[0] = b;
+    cs->palette_len = 1;
+    cs->bits = 0;
+}
+
+/*
+ * Returned integer has (1 << dir) set if modifying block in pos would affect the 
+ * chunk sec in that dir (As in need remeshing).
+ */
+uint8_t chunk_sec_get_block_affected(csbpos pos) 
+{
+    uint8_t ret = 0;
+    if      (pos.z == 0)                  ret |= (1 << DIR_NORTH);
+    else if (pos.z == CHUNK_SIDE-1)       ret |= (1 << DIR_SOUTH);
+    if      (pos.x == CHUNK_SIDE-1)       ret |= (1 << DIR_EAST);
+    else if (pos.x == 0)                  ret |= (1 << DIR_WEST);
+    if      (pos.y == CHUNK_SEC_HEIGHT-1) ret |= (1 << DIR_UP);
+    else if (pos.y == 0)                  ret |= (1 << DIR_DOWN);
+    return ret;
+}
+
+static void chunk_sec_set_block(chunk_sec *cs, csbpos pos, block_type b)
+{
+    block_type prev = chunk_sec_get_block(cs, pos);
+    if (prev == b) return;
+    if (prev == BLOCK_AIR && b != BLOCK_AIR) {
+        cs->block_count++;
+    } else if (b == BLOCK_AIR && prev != BLOCK_AIR) {
+        cs->block_count--;
+        if (cs->block_count == 0) {
+            chunk_sec_reset(cs, BLOCK_AIR);
+            return;
+        }
+    }
+
+    uint8_t entry = chunk_sec_palette_entry(cs, b);
+    if (cs->bits == 8) {
+        cs->indices[chunk_sec_block_index(pos)] = b;
+    } else {
+        chunk_sec_set_entry(cs, chunk_sec_block_index(pos), entry);
+    }
+    chunk_sec_set_occupied(cs, pos, b != BLOCK_AIR);
+}
+
+static void chunk_sec_fill_column(chunk_sec *cs, int x, int z, int y_start, int y_end, block_type b)
+{
+    uint8_t entry = chunk_sec_palette_entry(cs, b);
+    for (int y = y_start; y < y_end; y++) {
+        csbpos pos = {x, y, z};
+        block_type prev = chunk_sec_get_block(cs, pos);
+        if (prev == b) continue;
+        if (prev == BLOCK_AIR) {
+            cs->block_count++;
+        } else if (b == BLOCK_AIR) {
+            cs->block_count--;
+        }
+        if (cs->bits == 8) {
+            cs->indices[chunk_sec_block_index(pos)] = b;
+        } else {
+            chunk_sec_set_entry(cs, chunk_sec_block_index(pos), entry);
+        }
+        chunk_sec_set_occupied(cs, pos, b != BLOCK_AIR);
+    }
+    if (cs->block_count == 0) {
+        chunk_sec_reset(cs, BLOCK_AIR);
+    }
+}
+
+static void chunk_sec_encode(chunk_sec *cs, const uint8_t (*data)[CHUNK_SEC_SIZE])
+{
+    // 1 + palette entry of each block type seen so far
+    uint8_t entries[UINT8_MAX + 1] = {0};
+    uint8_t palette[CHUNK_SEC_PALETTE_CAP];
+    uint8_t palette_len = 0;
+    bool direct = false;
+    uint16_t block_count = 0;
+    for (size_t i = 0; i < CHUNK_SEC_SIZE; i++) {
+        uint8_t b = (*data)[i];
+        block_count += b != BLOCK_AIR;
+        if (entries[b] != 0) continue;
+        if (palette_len == CHUNK_SEC_PALETTE_CAP) {
+            direct = true;
+            continue;
+        }
+        palette[palette_len] = b;
+        entries[b] = ++palette_len;
+    }
+
+    free(cs->indices);
+    free(cs->occupancy);
+    cs->indices = NULL;
+    cs->occupancy = NULL;
+    cs->block_count = block_count;
+    if (direct) {
+        // the palette is left full, as it is when chunk_sec_palette_entry grows a section to 8 bits
+        memcpy(cs->palette, palette, palette_len);
+        cs->palette_len = palette_len;
+        cs->bits = 8;
+        cs->indices = malloc(CHUNK_SEC_SIZE);
+        memcpy(cs->indices, *data, CHUNK_SEC_SIZE);
+        cs->occupancy = malloc(CHUNK_SEC_ROWS * sizeof(*cs->occupancy));
+        chunk_sec_build_occupancy(cs, data);
+        return;
+    }
+    memcpy(cs->palette, palette, palette_len);
+    cs->palette_len = palette_len;
+    cs->bits = palette_len == 1 ? 0 : palette_len <= 2 ? 1 : palette_len <= 4 ? 2 : 4;
+    if (cs->bits == 0) return;
+    cs->occupancy = malloc(CHUNK_SEC_ROWS * sizeof(*cs->occupancy));
+    chunk_sec_build_occupancy(cs, data);
+    // packs whole bytes at a time rather than going through chunk_sec_set_entry
+    size_t size = chunk_sec_indices_size(cs->bits);
+    size_t per_byte = 8 / cs->bits;
+    cs->indices = malloc(size);
+    for (size_t i = 0; i < size; i++) {
+        uint8_t byte = 0;
+        for (size_t j = 0; j < per_byte; j++) {
+            byte |= (entries[(*data)[i * per_byte + j]] - 1) << (j * cs->bits);
+        }
+        cs->indices[i] = byte;
+    }
+}
+
+static void chunk_sec_destroy(chunk_sec *cs)
+{
+    free(cs->indices);
+    free(cs->occupancy);
+}
+
+LIST_DEFINE(shader_chunk_vertex)
+LIST_DEFINE(uint8_t)
+
+static chunk_mesher mesher = CHUNK_MESHER_GREEDY;
+
+/*
+ * Computes the visible faces of every row of the snapshot's section, with bit x of visible[face][y][z] set if the 
+ * block at (x, y, z) has a visible face in dir face: it's occupied and its neighbour in that dir isn't.
+ * Every block but air is opaque, so occupancy alone decides visibility. Neighbours along x are lined up by 
+ * shifting the row itself, the others are whole rows of the padded volume.
+ */
+static void snapshot_visible_faces(const chunk_sec_snapshot *snap, uint16_t (*visible)[DIRS_COUNT][CHUNK_SEC_HEIGHT][CHUNK_SIDE])
+{
+    const uint32_t (*o)[CHUNK_SNAPSHOT_SIDE] = snap->occupancy;
+    for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            uint32_t row = o[y+1][z+1];
+            (*visible)[DIR_NORTH][y][z] = (row & ~o[y+1][z])   >> 1;
+            (*visible)[DIR_SOUTH][y][z] = (row & ~o[y+1][z+2]) >> 1;
+            (*visible)[DIR_EAST][y][z]  = (row & ~(row >> 1))  >> 1;
+            (*visible)[DIR_WEST][y][z]  = (row & ~(row << 1))  >> 1;
+            (*visible)[DIR_UP][y][z]    = (row & ~o[y+2][z+1]) >> 1;
+            (*visible)[DIR_DOWN][y][z]  = (row & ~o[y][z+1])   >> 1;
+        }
+    }
+}
+
+// axes (0 = x, 1 = y, 2 = z) along which the uv s and t of each face in block_face_vertices run
+static const struct { int normal, s, t; } face_axes[DIRS_COUNT] = {
+    [DIR_NORTH] = {2, 0, 1},
+    [DIR_SOUTH] = {2, 0, 1},
+    [DIR_EAST]  = {0, 2, 1},
+    [DIR_WEST]  = {0, 2, 1},
+    [DIR_UP]    = {1, 0, 2},
+    [DIR_DOWN]  = {1, 0, 2},
+};
+
+/*
+ * Adds a face quad with its lower corner at (x, y, z) covering w blocks along the face's s axis and 
+ * h blocks along its t axis. The texture is repeated once per block.
+ */
+static void mesh_add_quad(chunk_mesh *m, dir face, int x, int y, int z, int w, int h, block_atlas_index tex)
+{
+    int extent[3] = {1, 1, 1};
+    extent[face_axes[face].s] = w;
+    extent[face_axes[face].t] = h;
+    uint32_t b = (uint32_t)tex.s << SHADER_CHUNK_TILE_S_SHIFT | (uint32_t)tex.t << SHADER_CHUNK_TILE_T_SHIFT;
+
+    for (int i = 0; i < BLOCK_FACE_VERTICES_COUNT; i++) {
+        // the template's coordinates are all 0 or 1
+        const shader_block_vertex *tv = &block_face_vertices[face][i];
+        shader_chunk_vertex *v = list_shader_chunk_vertex_add(&m->vertices);
+        v->a = (uint32_t)(x + (int)tv->pos_x * extent[0]) << SHADER_CHUNK_X_SHIFT
+             | (uint32_t)(y + (int)tv->pos_y * extent[1]) << SHADER_CHUNK_Y_SHIFT
+             | (uint32_t)(z + (int)tv->pos_z * extent[2]) << SHADER_CHUNK_Z_SHIFT
+             | (uint32_t)face                              << SHADER_CHUNK_FACE_SHIFT
+             | (uint32_t)((int)tv->uv_s * w)               << SHADER_CHUNK_S_SHIFT
+             | (uint32_t)((int)tv->uv_t * h)               << SHADER_CHUNK_T_SHIFT;
+        v->b = b;
+    }
+}
+
+static void chunk_mesh_build_naive(chunk_mesh *m, const chunk_sec_snapshot *snap)
+{
+    uint16_t visible[DIRS_COUNT][CHUNK_SEC_HEIGHT][CHUNK_SIDE];
+    snapshot_visible_faces(snap, &visible);
+
+    for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            uint32_t any = 0;
+            for (dir face = 0; face < DIRS_COUNT; face++) {
+                any |= visible[face][y][z];
+            }
+            for (; any != 0; any &= any - 1) {
+                int x = __builtin_ctz(any);
+                block_type b = snap->blocks[y][z][x];
+                for (dir face = 0; face < DIRS_COUNT; face++) {
+                    if ((visible[face][y][z] >> x & 1) == 0) continue;
+                    mesh_add_quad(m, face, x, y, z, 1, 1, block_atlas_indices[b][face]);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Merges coplanar visible faces sharing the same atlas texture into rectangles.
+ * Each face direction is swept one slice at a time along its normal; the slice's visible faces are put in a 
+ * mask which is then greedily covered by growing a run along s first, then extending it along t.
+ */
+static void chunk_mesh_build_greedy(chunk_mesh *m, const chunk_sec_snapshot *snap)
+{
+    // 0 for no face, otherwise 1 + index of the face's texture in the atlas
+    uint16_t mask[CHUNK_SIDE][CHUNK_SIDE];
+    const int atlas_cols = BLOCK_ATLAS_WIDTH / BLOCK_TEX_SIDE;
+    _Static_assert(CHUNK_SIDE == CHUNK_SEC_HEIGHT, "greedy mesher assumes cubic sections");
+
+    uint16_t visible[DIRS_COUNT][CHUNK_SEC_HEIGHT][CHUNK_SIDE];
+    snapshot_visible_faces(snap, &visible);
+
+    for (dir face = 0; face < DIRS_COUNT; face++) {
+        int na = face_axes[face].normal, sa = face_axes[face].s, ta = face_axes[face].t;
+        // the face's visible rows regrouped by slice, with bit s of rows[d][t] set for a face at (d, s, t)
+        uint16_t rows[CHUNK_SIDE][CHUNK_SIDE];
+        if (sa == 0) {
+            for (int d = 0; d < CHUNK_SIDE; d++) {
+                for (int t = 0; t < CHUNK_SIDE; t++) {
+                    rows[d][t] = na == 1 ? visible[face][d][t] : visible[face][t][d];
+                }
+            }
+        } else {
+            // x is the normal, transpose each y's rows so z runs along them
+            memset(rows, 0, sizeof(rows));
+            for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
+                for (int z = 0; z < CHUNK_SIDE; z++) {
+                    for (uint32_t bits = visible[face][y][z]; bits != 0; bits &= bits - 1) {
+                        rows[__builtin_ctz(bits)][y] |= 1u << z;
+                    }
+                }
+            }
+        }
+
+        for (int d = 0; d < CHUNK_SIDE; d++) {
+            uint16_t any = 0;
+            for (int t = 0; t < CHUNK_SIDE; t++) {
+                any |= rows[d][t];
+            }
+            if (any == 0) continue;
+
+            memset(mask, 0, sizeof(mask));
+            for (int t = 0; t < CHUNK_SIDE; t++) {
+                for (uint32_t bits = rows[d][t]; bits != 0; bits &= bits - 1) {
+                    int s = __builtin_ctz(bits);
+                    int p[3];
+                    p[na] = d; p[sa] = s; p[ta] = t;
+                    block_type b = snap->blocks[p[1]][p[2]][p[0]];
+                    block_atlas_index tex = block_atlas_indices[b][face];
+                    mask[t][s] = 1 + tex.t * atlas_cols + tex.s;
+                }
+            }
+
+            for (int t = 0; t < CHUNK_SIDE; t++) {
+                for (int s = 0; s < CHUNK_SIDE; ) {
+                    uint16_t k = mask[t][s];
+                    if (k == 0) { s++; continue; }
+                    block_atlas_index tex = {(k - 1) % atlas_cols, (k - 1) / atlas_cols};
+
+                    int w = 1;
+                    while (s + w < CHUNK_SIDE && mask[t][s + w] == k) w++;
+                    int h = 1;
+                    for (; t + h < CHUNK_SIDE; h++) {
+                        bool row_matches = true;
+                        for (int i = 0; i < w; i++) {
+                            if (mask[t + h][s + i] != k) { row_matches = false; break; }
+                        }
+                        if (!row_matches) break;
+                    }
+                    for (int j = 0; j < h; j++) {
+                        for (int i = 0; i < w; i++) {
+                            mask[t + j][s + i] = 0;
+                        }
+                    }
+
+                    int p[3];
+                    p[na] = d; p[sa] = s; p[ta] = t;
+                    mesh_add_quad(m, face, p[0], p[1], p[2], w, h, tex);
+                    s += w;
+                }
+            }
+        }
+    }
+}
+
+void chunk_mesh_init(chunk_mesh *m)
+{
+    list_shader_chunk_vertex_init(&m->vertices);
+}
+
+/*
+ * Flood fills each pocket of air in the section, and links every pair of faces a pocket touches. 
+ * Sections reached through a face can only see out through the faces it's linked to.
+ * The fill spreads a row at a time: along a row with shifts, then to the rows next to it.
+ */
+static void chunk_mesh_build_sees(chunk_mesh *m, const chunk_sec_snapshot *snap)
+{
+    // air blocks no fill has reached yet, a row per (y, z)
+    uint16_t open[CHUNK_SEC_HEIGHT][CHUNK_SIDE];
+    // solid blocks of the section, and of its faces
+    uint16_t solid = 0, shell = 0;
+    for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            uint16_t row = snap->occupancy[y + 1][z + 1] >> 1 & CHUNK_SEC_ROW_FULL;
+            open[y][z] = ~row & CHUNK_SEC_ROW_FULL;
+            solid |= row;
+            if (y == 0 || y == CHUNK_SEC_HEIGHT - 1 || z == 0 || z == CHUNK_SIDE - 1) shell |= row;
+        }
+    }
+    shell |= solid & (1 | 1 << (CHUNK_SIDE - 1));
+    // faces of open air are all joined through the air around the section's edges
+    if (shell == 0) {
+        memset(m->sees, CHUNK_SEC_SEES_ALL, sizeof(m->sees));
+        return;
+    }
+
+    memset(m->sees, 0, sizeof(m->sees));
+    // blocks the fill reached in each row but hasn't spread from yet
+    uint16_t pending[CHUNK_SEC_HEIGHT][CHUNK_SIDE] = {0};
+    // rows with pending blocks, as y * CHUNK_SIDE + z. A row is on it at most once
+    uint16_t stack[CHUNK_SEC_HEIGHT * CHUNK_SIDE];
+    for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            while (open[y][z] != 0) {
+                pending[y][z] = open[y][z] & -open[y][z];
+                size_t len = 0;
+                stack[len++] = y * CHUNK_SIDE + z;
+                uint8_t faces = 0;
+                while (len > 0) {
+                    int ry = stack[len - 1] / CHUNK_SIDE, rz = stack[len - 1] % CHUNK_SIDE;
+                    len--;
+                    uint16_t row = open[ry][rz];
+                    uint16_t fill = pending[ry][rz];
+                    pending[ry][rz] = 0;
+                    for (uint16_t prev = 0; fill != prev; ) {
+                        prev = fill;
+                        fill |= (fill << 1 | fill >> 1) & row;
+                    }
+                    open[ry][rz] = row & ~fill;
+
+                    if (fill & 1) faces |= 1 << DIR_WEST;
+                    if (fill >> (CHUNK_SIDE - 1)) faces |= 1 << DIR_EAST;
+                    if (rz == 0) faces |= 1 << DIR_NORTH;
+                    if (rz == CHUNK_SIDE - 1) faces |= 1 << DIR_SOUTH;
+                    if (ry == 0) faces |= 1 << DIR_DOWN;
+                    if (ry == CHUNK_SEC_HEIGHT - 1) faces |= 1 << DIR_UP;
+                    int next[4][2] = {{ry, rz - 1}, {ry, rz + 1}, {ry - 1, rz}, {ry + 1, rz}};
+                    for (int i = 0; i < 4; i++) {
+                        int ny = next[i][0], nz = next[i][1];
+                        if (ny < 0 || ny >= CHUNK_SEC_HEIGHT || nz < 0 || nz >= CHUNK_SIDE) continue;
+                        uint16_t reached = fill & open[ny][nz] & ~pending[ny][nz];
+                        if (reached == 0) continue;
+                        if (pending[ny][nz] == 0) stack[len++] = ny * CHUNK_SIDE + nz;
+                        pending[ny][nz] |= reached;
+                    }
+                }
+                for (dir d = 0; d < DIRS_COUNT; d++) {
+                    if (faces & 1 << d) m->sees[d] |= faces;
+                }
+            }
+        }
+    }
+}
+
+void chunk_mesh_build(chunk_mesh *m, const chunk_sec_snapshot *snap, chunk_mesher mesher, bool sees)
+{
+    list_shader_chunk_vertex_clear(&m->vertices);
+    if (sees) {
+        chunk_mesh_build_sees(m, snap);
+    } else {
+        memset(m->sees, CHUNK_SEC_SEES_ALL, sizeof(m->sees));
+    }
+
+    switch (mesher) {
+    case CHUNK_MESHER_NAIVE:  chunk_mesh_build_naive(m, snap); break;
+    case CHUNK_MESHER_GREEDY: chunk_mesh_build_greedy(m, snap); break;
+    default: unreachable();
+    }
+}
+
+void chunk_mesh_destroy(chunk_mesh *m)
+{
+    list_shader_chunk_vertex_destroy(&m->vertices);
+}
+
+void chunk_set_mesher(chunk_mesher m)
+{
+    mesher = m;
+}
+
+chunk_mesher chunk_get_mesher(void)
+{
+    return mesher;
+}
+
+const char *chunk_mesher_name(chunk_mesher m)
+{
+    switch (m) {
+    case CHUNK_MESHER_NAIVE:  return "naive";
+    case CHUNK_MESHER_GREEDY: return "greedy";
+    default:
+        unreachable();
+        return NULL;
+    }
+}
+
+void chunk_init(chunk *c) 
+{
+    c->meshed = false;
+    c->dirty = true;
+    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
+        chunk_sec_init(&c->secs[i]);
+    }
+}
+
+void chunk_set_block(chunk *c, cbpos pos, block_type b)
+{
+    int section = section_from_cbpos(pos);
+    chunk_sec *cs = &c->secs[section];
+    csbpos p = cbpos_to_csbpos(pos);
+    chunk_sec_set_block(cs, p, b);
+    c->dirty = true;
+}
+
+void chunk_fill_column(chunk *c, int x, int z, int y_start, int y_end, block_type b)
+{
+    if (y_start >= y_end) return;
+    for (int sec = y_start / CHUNK_SEC_HEIGHT; sec <= (y_end - 1) / CHUNK_SEC_HEIGHT; sec++) {
+        int sec_y = sec * CHUNK_SEC_HEIGHT;
+        int start = y_start > sec_y ? y_start - sec_y : 0;
+        int end = y_end < sec_y + CHUNK_SEC_HEIGHT ? y_end - sec_y : CHUNK_SEC_HEIGHT;
+        chunk_sec_fill_column(&c->secs[sec], x, z, start, end, b);
+    }
+    c->dirty = true;
+}
+
+void chunk_set_sec_blocks(chunk *c, int sec, const uint8_t (*data)[CHUNK_SEC_SIZE])
+{
+    chunk_sec_encode(&c->secs[sec], data);
+    c->dirty = true;
+}
+
+block_type chunk_get_block(const chunk *c, cbpos pos)
+{
+    int section = section_from_cbpos(pos);
+    const chunk_sec *cs = &c->secs[section];
+    csbpos p = cbpos_to_csbpos(pos);
+    return chunk_sec_get_block(cs, p);
+}
+
+void chunk_snapshot_sec(const chunk *c, int sec, const chunk *(*dir_chunks)[4], chunk_sec_snapshot *snap)
+{
+    const chunk_sec *cs = &c->secs[sec];
+    const chunk_sec *dir_secs[DIRS_COUNT] = {
+        (*dir_chunks)[DIR_NORTH] == NULL ? NULL : &(*dir_chunks)[DIR_NORTH]->secs[sec], 
+        (*dir_chunks)[DIR_SOUTH] == NULL ? NULL : &(*dir_chunks)[DIR_SOUTH]->secs[sec], 
+        (*dir_chunks)[DIR_EAST] == NULL ? NULL : &(*dir_chunks)[DIR_EAST]->secs[sec], 
+        (*dir_chunks)[DIR_WEST] == NULL ? NULL : &(*dir_chunks)[DIR_WEST]->secs[sec], 
+        sec == CHUNK_SEC_COUNT-1 ? NULL : &c->secs[sec+1], 
+        sec == 0 ? NULL : &c->secs[sec-1], 
+    };
+
+    chunk_sec_decode(cs, (uint8_t (*)[CHUNK_SEC_SIZE])snap->blocks);
+
+    // missing chunks are map edges and hide the faces against them, while sections above and below the world are air
+    const uint32_t edge = (uint32_t)CHUNK_SEC_ROW_FULL << 1;
+    uint32_t (*o)[CHUNK_SNAPSHOT_SIDE] = snap->occupancy;
+    memset(o, 0, sizeof(snap->occupancy));
+    for (int y = 0; y < CHUNK_SEC_HEIGHT; y++) {
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            uint32_t east = dir_secs[DIR_EAST] == NULL ? 1 : chunk_sec_get_row(dir_secs[DIR_EAST], y, z) & 1;
+            uint32_t west = dir_secs[DIR_WEST] == NULL ? 1 : chunk_sec_get_row(dir_secs[DIR_WEST], y, z) >> (CHUNK_SIDE-1);
+            o[y+1][z+1] = west | (uint32_t)chunk_sec_get_row(cs, y, z) << 1 | east << (CHUNK_SIDE+1);
+        }
+        o[y+1][0] = dir_secs[DIR_NORTH] == NULL ? edge : (uint32_t)chunk_sec_get_row(dir_secs[DIR_NORTH], y, CHUNK_SIDE-1) << 1;
+        o[y+1][CHUNK_SIDE+1] = dir_secs[DIR_SOUTH] == NULL ? edge : (uint32_t)chunk_sec_get_row(dir_secs[DIR_SOUTH], y, 0) << 1;
+    }
+    for (int z = 0; z < CHUNK_SIDE; z++) {
+        if (dir_secs[DIR_UP] != NULL) o[CHUNK_SEC_HEIGHT+1][z+1] = (uint32_t)chunk_sec_get_row(dir_secs[DIR_UP], 0, z) << 1;
+        if (dir_secs[DIR_DOWN] != NULL) o[0][z+1] = (uint32_t)chunk_sec_get_row(dir_secs[DIR_DOWN], CHUNK_SEC_HEIGHT-1, z) << 1;
+    }
+}
+
+void chunk_release_sec_mesh(chunk *c, int sec, mesh_buffer *buf)
+{
+    mesh_buffer_release(buf, &c->secs[sec].mesh);
+}
+
+void chunk_release_meshes(chunk *c, mesh_buffer *buf)
+{
+    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
+        chunk_release_sec_mesh(c, i, buf);
+    }
+}
+
+void chunk_upload_sec(chunk *c, cpos pos, int sec, chunk_mesh *m, mesh_buffer *buf)
+{
+    bpos origin = cpos_to_bpos(pos);
+    origin.y += sec * CHUNK_SEC_HEIGHT;
+    mesh_buffer_upload(buf, &c->secs[sec].mesh, origin, m->vertices.data, m->vertices.len);
+    memcpy(c->secs[sec].sees, m->sees, sizeof(m->sees));
+}
+
+uint8_t chunk_sec_sees(const chunk *c, int sec, dir from)
+{
+    const chunk_sec *cs = &c->secs[sec];
+    // emptied sections aren't meshed again
+    return cs->block_count == 0 ? CHUNK_SEC_SEES_ALL : cs->sees[from];
+}
+
+void chunk_remesh_sec(chunk *c, cpos pos, int sec, const chunk *(*dir_chunks)[4], mesh_buffer *buf)
+{
+    chunk_sec *cs = &c->secs[sec];
+    // anything still meshing in the background for this section is now stale
+    cs->mesh_version++;
+    if (cs->block_count == 0) {
+        chunk_release_sec_mesh(c, sec, buf);
+        return;
+    }
+
+    chunk_sec_snapshot snap;
+    chunk_mesh m;
+    chunk_snapshot_sec(c, sec, dir_chunks, &snap);
+    chunk_mesh_init(&m);
+    chunk_mesh_build(&m, &snap, mesher, true);
+    chunk_upload_sec(c, pos, sec, &m, buf);
+    chunk_mesh_destroy(&m);
+}
+
+void chunk_remesh(chunk *c, cpos pos, const chunk * (*dir_chunks)[4], mesh_buffer *buf)
+{
+    for (int section = 0; section < CHUNK_SEC_COUNT; section++) {
+        chunk_remesh_sec(c, pos, section, dir_chunks, buf);
+    }
+}
+
+void chunk_render(const chunk *c, mesh_buffer *buf)
+{
+    for (int section = 0; section < CHUNK_SEC_COUNT; section++) {
+        mesh_buffer_draw(buf, &c->secs[section].mesh);
+    }
+}
+
+void chunk_add_sec_bounds(chunk *c, cpos pos, AABB_soa *bounds, list_mesh_alloc_ptr *meshes)
+{
+    bpos origin = cpos_to_bpos(pos);
+    for (int section = 0; section < CHUNK_SEC_COUNT; section++) {
+        chunk_sec *cs = &c->secs[section];
+        if (cs->mesh.index_count == 0) continue;
+        float y = section * CHUNK_SEC_HEIGHT;
+        AABB aabb = {{origin.x, y, origin.z}, {origin.x + CHUNK_SIDE, y + CHUNK_SEC_HEIGHT, origin.z + CHUNK_SIDE}};
+        AABB_soa_add(bounds, &aabb);
+        *list_mesh_alloc_ptr_add(meshes) = &cs->mesh;
+    }
+}
+
+size_t chunk_block_storage_size(const chunk *c)
+{
+    size_t size = 0;
+    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
+        const chunk_sec *cs = &c->secs[i];
+        size += sizeof(cs->indices) + sizeof(cs->palette) + sizeof(cs->palette_len) + sizeof(cs->bits);
+        size += chunk_sec_indices_size(cs->bits);
+        size += sizeof(cs->occupancy) + (cs->occupancy == NULL ? 0 : CHUNK_SEC_ROWS * sizeof(*cs->occupancy));
+    }
+    return size;
+}
+
+static void serialize_bytes(list_uint8_t *out, const void *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        *list_uint8_t_add(out) = ((const uint8_t *)data)[i];
+    }
+}
+
+/*
+ * Each section is written as bits, palette_len, the palette, block_count (native byte order), then unless 
+ * bits is 0 the indices bytes run length encoded as (run length 1-255, byte) pairs.
+ */
+void chunk_serialize(const chunk *c, list_uint8_t *out)
+{
+    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
+        const chunk_sec *cs = &c->secs[i];
+        *list_uint8_t_add(out) = cs->bits;
+        *list_uint8_t_add(out) = cs->palette_len;
+        serialize_bytes(out, cs->palette, cs->palette_len);
+        serialize_bytes(out, &cs->block_count, sizeof(cs->block_count));
+
+        size_t size = chunk_sec_indices_size(cs->bits);
+        for (size_t j = 0; j < size; ) {
+            uint8_t value = cs->indices[j];
+            size_t run = 1;
+            while (j + run < size && run < UINT8_MAX && cs->indices[j + run] == value) run++;
+            *list_uint8_t_add(out) = run;
+            *list_uint8_t_add(out) = value;
+            j += run;
+        }
+    }
+}
+
+bool chunk_deserialize(chunk *c, const uint8_t *buf, size_t len)
+{
+    const uint8_t *end = buf + len;
+    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
+        chunk_sec *cs = &c->secs[i];
+        if (end - buf < 2) return false;
+        uint8_t bits = *buf++;
+        uint8_t palette_len = *buf++;
+        if (bits != 0 && bits != 1 && bits != 2 && bits != 4 && bits != 8) return false;
+        if (palette_len == 0 || palette_len > CHUNK_SEC_PALETTE_CAP) return false;
+        if (bits < 8 && palette_len > (1 << bits)) return false;
+        if (end - buf < palette_len + 2) return false;
+        for (int j = 0; j < palette_len; j++) {
+            if (buf[j] >= BLOCKS_COUNT) return false;
+        }
+        cs->bits = bits;
+        cs->palette_len = palette_len;
+        memcpy(cs->palette, buf, palette_len);
+        buf += palette_len;
+        memcpy(&cs->block_count, buf, sizeof(cs->block_count));
+        buf += sizeof(cs->block_count);
+
+        size_t size = chunk_sec_indices_size(bits);
+        if (size == 0) {
+            if (cs->block_count != (cs->palette[0] == BLOCK_AIR ? 0 : CHUNK_SEC_SIZE)) return false;
+            continue;
+        }
+        cs->indices = malloc(size);
+        cs->occupancy = calloc(CHUNK_SEC_ROWS, sizeof(*cs->occupancy));
+        for (size_t j = 0; j < size; ) {
+            if (end - buf < 2) return false;
+            uint8_t run = *buf++;
+            uint8_t value = *buf++;
+            if (run == 0 || run > size - j) return false;
+            memset(cs->indices + j, value, run);
+            j += run;
+        }
+        // packed entries past the palette would decode to whatever its unused slots hold
+        for (size_t j = 0; bits < 8 && j < CHUNK_SEC_SIZE; j++) {
+            if (chunk_sec_get_entry(cs, j) >= palette_len) return false;
+        }
+        uint8_t data[CHUNK_SEC_SIZE];
+        chunk_sec_decode(cs, &data);
+        // the meshers index block tables by type, and meshing and culling trust block_count
+        uint16_t block_count = 0;
+        for (size_t j = 0; j < CHUNK_SEC_SIZE; j++) {
+            if (data[j] >= BLOCKS_COUNT) return false;
+            block_count += data[j] != BLOCK_AIR;
+        }
+        if (block_count != cs->block_count) return false;
+        chunk_sec_build_occupancy(cs, (const uint8_t (*)[CHUNK_SEC_SIZE])&data);
+    }
+    c->dirty = false;
+    return buf == end;
+}
+
+void chunk_destroy(chunk *c)
+{
+    for (int i = 0; i < CHUNK_SEC_COUNT; i++) {
+        chunk_sec_destroy(&c->secs[i]);
+    }
 }
\ No newline at end of file
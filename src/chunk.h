@@ -1,30 +1,126 @@
-#pragma once
-
-#include "glad.h"
-#include "block.h"
-#include <stdint.h>
-#include "pos.h"
-#include "cgmath.h"
-#include "camera.h"
-#include "shaders/shader_block.h"
-
-typedef struct chunk_sec {
-    // yzx
-    uint8_t  data[CHUNK_SEC_HEIGHT][CHUNK_SIDE][CHUNK_SIDE];
-    GLuint   vao, ebo, vbo;
-    uint16_t block_count;
-    size_t   index_count;
-} chunk_sec;
-
-typedef struct chunk {
-    chunk_sec secs[CHUNK_SEC_COUNT];
-} chunk;
-
-void       chunk_init(chunk *c);
-block_type chunk_get_block(const chunk *c, cbpos pos);
-void       chunk_set_block(chunk *const c, cbpos pos, block_type b);
-uint8_t    chunk_setr_block(chunk *c, cbpos pos, block_type b, chunk *(*dir_chunks)[4]);
-void       chunk_render(const chunk *c, cpos pos, const camera *camera, shader_block *shader);
-void       chunk_remesh(chunk *c, const chunk * (*dir_chunks)[4]);
-void       chunk_remesh_sec(chunk *c, int sec, const chunk *(*dir_chunks)[4]);
-void       chunk_destroy(chunk *c);
\ No newline at end of file
+#pragma once
+
+#include "glad.h"
+#include "block.h"
+#include <stdint.h>
+#include "pos.h"
+#include "cgmath.h"
+#include "camera.h"
+#include "shaders/shader_chunk.h"
+#include "containers/list.h"
+#include "containers/gl_list.h"
+#include "mesh_buffer.h"
+
+// palette entries kept before a section switches to storing block types directly
+#define CHUNK_SEC_PALETTE_CAP 16
+// every face of an empty section sees every other
+#define CHUNK_SEC_SEES_ALL    ((1 << DIRS_COUNT) - 1)
+
+/*
+ * Blocks are palette compressed. indices holds a bits wide entry per block in yzx order, packed into bytes.
+ * bits == 0: the whole section is palette[0] and indices is NULL.
+ * bits 1-4:  entries index palette, which holds up to 1 << bits block types.
+ * bits == 8: entries are the block types themselves and palette is unused.
+ * bits only grows as new block types are set, except that a section emptied of blocks goes back to uniform air.
+ * occupancy has a row per (y, z) with bit x set if the block at (x, y, z) isn't air, so the mesher can find 
+ * visible faces a row at a time. Like indices it's NULL while bits == 0, the rows then all follow palette[0].
+ */
+typedef struct chunk_sec {
+    uint8_t  *indices;
+    uint16_t *occupancy;
+    uint8_t  palette[CHUNK_SEC_PALETTE_CAP];
+    uint8_t  palette_len;
+    uint8_t  bits;
+    uint16_t block_count;
+    // the section's mesh in the world's mesh_buffer, as most sections are air most have none
+    mesh_alloc mesh;
+    // bumped on every remesh request so meshes built from older snapshots can be discarded
+    uint32_t mesh_version;
+    // bit j of sees[i] is set if face j can be seen from face i through the section's air, as of the last mesh
+    uint8_t  sees[DIRS_COUNT];
+    // the world's render frame that last reached the section while looking for visible sections
+    uint32_t visit_frame;
+} chunk_sec;
+
+/*
+ * How sections are turned into meshes.
+ * Naive emits one quad per visible block face, greedy merges coplanar faces with the same texture.
+ */
+typedef enum chunk_mesher {
+    CHUNK_MESHER_NAIVE,
+    CHUNK_MESHER_GREEDY,
+
+    CHUNK_MESHERS_COUNT,
+} chunk_mesher;
+
+typedef struct chunk {
+    chunk_sec secs[CHUNK_SEC_COUNT];
+    // chunks are first meshed once all 4 neighbours are loaded, so their edges are only meshed once
+    bool      meshed;
+    // set when blocks change, cleared once the chunk is saved or loaded
+    bool      dirty;
+} chunk;
+
+/*
+ * Copy of everything needed to mesh a section, so it can be meshed off the GL thread while the world changes.
+ * occupancy holds the section's occupancy rows padded with a one block border from its 6 neighbours, with 
+ * bit x+1 for block x. Missing neighbour chunks are map edges and count as occupied so their faces aren't rendered.
+ * The padding's edges and corners are never read and left 0.
+ */
+#define CHUNK_SNAPSHOT_SIDE (CHUNK_SIDE + 2)
+
+typedef struct chunk_sec_snapshot {
+    uint8_t  blocks[CHUNK_SEC_HEIGHT][CHUNK_SIDE][CHUNK_SIDE];
+    // row (y, z) of the section is occupancy[y+1][z+1]
+    uint32_t occupancy[CHUNK_SEC_HEIGHT + 2][CHUNK_SNAPSHOT_SIDE];
+} chunk_sec_snapshot;
+
+LIST_DECLARE(shader_chunk_vertex)
+LIST_DECLARE(uint8_t)
+
+// cpu side mesh of a section, built by any thread and uploaded by the GL thread. Every 4 vertices are a quad.
+typedef struct chunk_mesh {
+    list_shader_chunk_vertex vertices;
+    // which faces see each other, as in chunk_sec
+    uint8_t                  sees[DIRS_COUNT];
+} chunk_mesh;
+
+void       chunk_init(chunk *c);
+block_type chunk_get_block(const chunk *c, cbpos pos);
+void       chunk_set_block(chunk *const c, cbpos pos, block_type b);
+// bit per direction of the neighbouring sections whose meshes include the block at pos
+uint8_t    chunk_sec_get_block_affected(csbpos pos);
+// sets blocks y_start <= y < y_end of the column at x, z to b, looking up b in each section's palette once
+void       chunk_fill_column(chunk *c, int x, int z, int y_start, int y_end, block_type b);
+// replaces every block of the section with data, in yzx order, picking the smallest storage that fits
+void       chunk_set_sec_blocks(chunk *c, int sec, const uint8_t (*data)[CHUNK_SEC_SIZE]);
+// draws or queues every section with a mesh through buf, for columns entirely in view
+void       chunk_render(const chunk *c, mesh_buffer *buf);
+// adds the bounds of each section with a mesh to bounds and its mesh to meshes, to cull them in batches
+void       chunk_add_sec_bounds(chunk *c, cpos pos, AABB_soa *bounds, list_mesh_alloc_ptr *meshes);
+void       chunk_remesh(chunk *c, cpos pos, const chunk * (*dir_chunks)[4], mesh_buffer *buf);
+// remeshes synchronously on the calling (GL) thread
+void       chunk_remesh_sec(chunk *c, cpos pos, int sec, const chunk *(*dir_chunks)[4], mesh_buffer *buf);
+void       chunk_snapshot_sec(const chunk *c, int sec, const chunk *(*dir_chunks)[4], chunk_sec_snapshot *snap);
+// an empty mesh releases the section's mesh. The mesh's vertices are tagged with the section's slot.
+void       chunk_upload_sec(chunk *c, cpos pos, int sec, chunk_mesh *m, mesh_buffer *buf);
+void       chunk_release_sec_mesh(chunk *c, int sec, mesh_buffer *buf);
+// faces of the section that can be seen from face from
+uint8_t    chunk_sec_sees(const chunk *c, int sec, dir from);
+// releases the meshes of every section, before the chunk is destroyed
+void       chunk_release_meshes(chunk *c, mesh_buffer *buf);
+void       chunk_mesh_init(chunk_mesh *m);
+// thread safe. Unless sees is set, every face is taken to see every other rather than filling the section's air
+void       chunk_mesh_build(chunk_mesh *m, const chunk_sec_snapshot *snap, chunk_mesher mesher, bool sees);
+void       chunk_mesh_destroy(chunk_mesh *m);
+void       chunk_destroy(chunk *c);
+// bytes used to store the chunk's blocks, to compare against CHUNK_SIZE for uncompressed storage
+size_t     chunk_block_storage_size(const chunk *c);
+// appends the chunk's blocks to out
+void       chunk_serialize(const chunk *c, list_uint8_t *out);
+// c must be freshly initialized. Returns false if buf is malformed or holds invalid blocks, leaving c partially filled.
+bool       chunk_deserialize(chunk *c, const uint8_t *buf, size_t len);
+// only affects sections remeshed afterwards
+void         chunk_set_mesher(chunk_mesher m);
+chunk_mesher chunk_get_mesher(void);
+const char  *chunk_mesher_name(chunk_mesher m);
\ No newline at end of file
@@ -1,3 +1,6 @@
-#include "gl_list.h"
-
-LIST_DEFINE(GLuint)
\ No newline at end of file
+#include "gl_list.h"
+
+LIST_DEFINE(GLuint)
+LIST_DEFINE(GLint)
+LIST_DEFINE(GLsizei)
+LIST_DEFINE(gl_offset)
\ No newline at end of file
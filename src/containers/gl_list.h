@@ -1,6 +1,12 @@
-#pragma once
-
-#include "list.h"
-#include "../glad.h"
-
-LIST_DECLARE(GLuint)
+#pragma once
+
+#include "list.h"
+#include "../glad.h"
+
+// byte offset into a bound buffer, as taken by the indices argument of the draw calls
+typedef const void *gl_offset;
+
+LIST_DECLARE(GLuint)
+LIST_DECLARE(GLint)
+LIST_DECLARE(GLsizei)
+LIST_DECLARE(gl_offset)
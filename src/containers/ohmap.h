@@ -0,0 +1,247 @@
+/*
+ * Implements a generic open addressing hashmap, with the same usage as hmap.h.
+ * Entries are stored inline in a single array and collisions are resolved by linear probing with
+ * robin hood ordering, so a lookup touches consecutive memory instead of following a chain of allocations.
+ * The price is that entries move on put, remove and resize: pointers to values are only valid until the
+ * map is next modified. Store large or address sensitive values by pointer.
+ * Usage
+ * =====
+ * OHMAP_DECLARE(K, V)
+ *     Defines structures ohmap_K_V and ohmap_K_V_entry, and declares the functions
+ *     If K or V is a pointer, then it has to be typedef'd
+ * OHMAP_DEFINE(K, V, hash_func, eq_func)
+ *     Defines the functions.
+ *     hash_func: Must have signature: uint32_t hash_func(const K *)
+ *     eq_func:   Must have signature: bool eq_func(const K *, const K *)
+ * OHMAP_ITER_BEGIN(h, element_name)
+ *     Starts a for loop where element_name is a pointer to ohmap_K_V_entry which can be used as iterator value.
+ *     Modifying the hashmap or entry except for the value is forbidden.
+ * OHMAP_ITER_END
+ *     Ends the for loop
+ * There should not be any semicolon after the macros.
+ *
+ * Functions
+ * =========
+ * Prefix of ohmap_K_V_ followed by:
+ * init_custom: Initiates the hashmap with given parameters and initial capacity is (rounded to next power of 2, at least 2).
+ *              Destructors can be NULL in which case they are ignored.
+ * init       : Init_custom with default parameters
+ * put        : Puts the key, returning a pointer to the value. The value of a new key is uninitialized.
+ * get        : Gets a pointer to the value associated with the key; returns NULL if it doesn't exist.
+ * remove     : Removes the entry associated with the key from the map, calling destructors for key and value.
+ *              Returns true if removed, false if it doesn't exist.
+ * clear      : Removes every entry, calling destructors, but keeps the capacity.
+ * destroy    : Destroys the map by freeing memory, and calling destructors of keys and values.
+ * There is no put_entry or extract, as entries aren't allocated individually.
+ *
+ * Example
+ * =======
+ * uint32_t int_hash(const int *i) { return *i; }
+ * bool int_eq(const int *a, const int *b) { return *a == *b; }
+ *
+ * OHMAP_DECLARE(int, int)
+ * OHMAP_DEFINE(int, int, int_hash, int_eq)
+ *
+ * ohmap_int_int h;
+ * ohmap_int_int_init(&h, NULL, NULL);
+ * *ohmap_int_int_put(&h, &(int){1}) = 2;
+ * printf("%d", *ohmap_int_int_get(&h, &(int){1})); // 2
+ * ohmap_int_int_remove(&h, &(int){1});
+ * printf("%" PRIu32, h.len); // 0
+ * ohmap_int_int_destroy(&h); // memory freed.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define OHMAP_DEFAULT_LOAD_FACTOR      0.75
+#define OHMAP_DEFAULT_INITIAL_CAPACITY 16
+
+#define OHMAP_DECLARE(K, V) \
+typedef struct ohmap_##K##_##V##_entry {\
+    /* 0 for an empty slot */\
+    uint32_t hash;\
+    K        key;\
+    V        value;\
+} ohmap_##K##_##V##_entry;\
+\
+typedef struct ohmap_##K##_##V {\
+    uint32_t                len;\
+    uint32_t                cap;\
+    float                   load_factor;\
+    uint32_t                threshold;\
+    /* 32 - log2(cap), the slot a hash wants is hash >> shift */\
+    uint32_t                shift;\
+    void                    (*key_destructor)(K *key);\
+    void                    (*value_destructor)(V *value);\
+    ohmap_##K##_##V##_entry *entries;\
+} ohmap_##K##_##V;\
+\
+void ohmap_##K##_##V##_init_custom(ohmap_##K##_##V *h, float load_factor, uint32_t initial_capacity, void (*key_destructor)(K *key), void (*value_destructor)(V *value));\
+void ohmap_##K##_##V##_init(ohmap_##K##_##V *h, void (*key_destructor)(K *key), void (*value_destructor)(V *value));\
+V   *ohmap_##K##_##V##_put(ohmap_##K##_##V *h, const K *key);\
+V   *ohmap_##K##_##V##_get(const ohmap_##K##_##V *h, const K *key);\
+bool ohmap_##K##_##V##_remove(ohmap_##K##_##V *h, const K *key);\
+void ohmap_##K##_##V##_clear(ohmap_##K##_##V *h);\
+void ohmap_##K##_##V##_destroy(ohmap_##K##_##V *h);
+
+#define OHMAP_ITER_BEGIN(h, element_name) \
+for (uint32_t element_name##i = 0; element_name##i < (h)->cap; element_name##i++) {\
+    typeof((h)->entries) element_name = &(h)->entries[element_name##i];\
+    if (element_name->hash != 0) {
+
+#define OHMAP_ITER_END \
+    }\
+}
+
+#define OHMAP_DEFINE(K, V, hash_func, eq_func)\
+void ohmap_##K##_##V##_init_custom(ohmap_##K##_##V *h, float load_factor, uint32_t initial_capacity, void (*key_destructor)(K *key), void (*value_destructor)(V *value))\
+{\
+    h->len = 0;\
+    uint32_t cap = 2;\
+    while (cap < initial_capacity)\
+        cap <<= 1;\
+    h->cap = cap;\
+    h->shift = 32 - __builtin_ctz(cap);\
+    h->load_factor = load_factor;\
+    h->threshold = load_factor * h->cap;\
+    h->key_destructor = key_destructor;\
+    h->value_destructor = value_destructor;\
+    h->entries = calloc(h->cap, sizeof(*h->entries));\
+}\
+\
+void ohmap_##K##_##V##_init(ohmap_##K##_##V *h, void (*key_destructor)(K *key), void (*value_destructor)(V *value))\
+{\
+    ohmap_##K##_##V##_init_custom(h, OHMAP_DEFAULT_LOAD_FACTOR, OHMAP_DEFAULT_INITIAL_CAPACITY, key_destructor, value_destructor);\
+}\
+\
+static uint32_t ohmap_##K##_##V##_hash(const K *key) \
+{\
+    /* fibonacci hashing, the slot is taken from the top bits which are mixed from all the bits. 0 marks empty slots */\
+    uint32_t h = hash_func(key) * 2654435769u;\
+    return h == 0 ? 1 : h;\
+}\
+\
+/* how far the entry at index is from the slot its hash wants */\
+static uint32_t ohmap_##K##_##V##_distance(const ohmap_##K##_##V *h, uint32_t index)\
+{\
+    return (index - (h->entries[index].hash >> h->shift)) & (h->cap - 1);\
+}\
+\
+/* index of key, or where to insert it. Entries are ordered by wanted slot, so stop at one wanting a later slot */\
+static uint32_t ohmap_##K##_##V##_find(const ohmap_##K##_##V *h, const K *key, uint32_t hash, bool *found)\
+{\
+    uint32_t mask = h->cap - 1;\
+    uint32_t index = hash >> h->shift;\
+    for (uint32_t dist = 0; ; index = (index + 1) & mask, dist++) {\
+        const ohmap_##K##_##V##_entry *e = &h->entries[index];\
+        if (e->hash == 0 || ohmap_##K##_##V##_distance(h, index) < dist) break;\
+        if (e->hash == hash && eq_func(&e->key, key)) {\
+            *found = true;\
+            return index;\
+        }\
+    }\
+    *found = false;\
+    return index;\
+}\
+\
+/* shifts the entries from index up to the next empty slot forward by one, freeing index */\
+static void ohmap_##K##_##V##_make_room(ohmap_##K##_##V *h, uint32_t index)\
+{\
+    uint32_t mask = h->cap - 1;\
+    uint32_t empty = index;\
+    while (h->entries[empty].hash != 0)\
+        empty = (empty + 1) & mask;\
+    while (empty != index) {\
+        uint32_t prev = (empty - 1) & mask;\
+        h->entries[empty] = h->entries[prev];\
+        empty = prev;\
+    }\
+}\
+\
+static void ohmap_##K##_##V##_resize(ohmap_##K##_##V *h) \
+{\
+    ohmap_##K##_##V new = *h;\
+    new.cap <<= 1;\
+    new.shift--;\
+    new.threshold = new.load_factor * new.cap;\
+    new.entries = calloc(new.cap, sizeof(*new.entries));\
+    for (uint32_t i = 0; i < h->cap; i++) {\
+        ohmap_##K##_##V##_entry *e = &h->entries[i];\
+        if (e->hash == 0) continue;\
+        bool found;\
+        uint32_t index = ohmap_##K##_##V##_find(&new, &e->key, e->hash, &found);\
+        ohmap_##K##_##V##_make_room(&new, index);\
+        new.entries[index] = *e;\
+    }\
+    free(h->entries);\
+    *h = new;\
+}\
+\
+V *ohmap_##K##_##V##_put(ohmap_##K##_##V *h, const K *key)\
+{\
+    uint32_t hash = ohmap_##K##_##V##_hash(key);\
+    bool found;\
+    uint32_t index = ohmap_##K##_##V##_find(h, key, hash, &found);\
+    if (found) return &h->entries[index].value;\
+    if (h->len >= h->threshold) {\
+        ohmap_##K##_##V##_resize(h);\
+        index = ohmap_##K##_##V##_find(h, key, hash, &found);\
+    }\
+    ohmap_##K##_##V##_make_room(h, index);\
+    ohmap_##K##_##V##_entry *e = &h->entries[index];\
+    e->hash = hash;\
+    e->key = *key;\
+    h->len++;\
+    return &e->value;\
+}\
+\
+V *ohmap_##K##_##V##_get(const ohmap_##K##_##V *h, const K *key)\
+{\
+    bool found;\
+    uint32_t index = ohmap_##K##_##V##_find(h, key, ohmap_##K##_##V##_hash(key), &found);\
+    return found ? &h->entries[index].value : NULL;\
+}\
+\
+bool ohmap_##K##_##V##_remove(ohmap_##K##_##V *h, const K *key)\
+{\
+    bool found;\
+    uint32_t index = ohmap_##K##_##V##_find(h, key, ohmap_##K##_##V##_hash(key), &found);\
+    if (!found) return false;\
+    ohmap_##K##_##V##_entry *e = &h->entries[index];\
+    if (h->key_destructor != NULL) h->key_destructor(&e->key);\
+    if (h->value_destructor != NULL) h->value_destructor(&e->value);\
+    /* shift the following entries back until one is already in the slot it wants */\
+    uint32_t mask = h->cap - 1;\
+    uint32_t next = (index + 1) & mask;\
+    while (h->entries[next].hash != 0 && ohmap_##K##_##V##_distance(h, next) != 0) {\
+        h->entries[index] = h->entries[next];\
+        index = next;\
+        next = (next + 1) & mask;\
+    }\
+    h->entries[index].hash = 0;\
+    h->len--;\
+    return true;\
+}\
+\
+void ohmap_##K##_##V##_clear(ohmap_##K##_##V *h)\
+{\
+    for (uint32_t i = 0; i < h->cap; i++) {\
+        ohmap_##K##_##V##_entry *e = &h->entries[i];\
+        if (e->hash == 0) continue;\
+        if (h->key_destructor != NULL) h->key_destructor(&e->key);\
+        if (h->value_destructor != NULL) h->value_destructor(&e->value);\
+        e->hash = 0;\
+    }\
+    h->len = 0;\
+}\
+\
+void ohmap_##K##_##V##_destroy(ohmap_##K##_##V *h)\
+{\
+    ohmap_##K##_##V##_clear(h);\
+    free(h->entries);\
+}
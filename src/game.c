@@ -1,128 +1,480 @@
-#include "game.h"
-#include <stdio.h>
-#include "util.h"
-#include <stdio.h>
-
-void game_init(game *g, GLFWwindow *window)
-{
-    g->window = window;
-    g->current_time = glfwGetTime();
-    g->accumulator = 0;
-    g->running = true;
-    world_init(&g->world);
-    model_init(&g->model);
-    selector_init(&g->selector);
-    mat4 proj_matrix;
-    mat4_init_perspective(&proj_matrix, rad_from_deg(100), 1024.0 / 800.0, 0.1, 1000);
-    camera_init_custom(&g->camera, &proj_matrix, &(vec3){30, 61, 30}, 0, 0);
-    g->mouse_state = (mouse_state){0, 0, true};
-    glfwSetCursorPos(g->window, g->mouse_state.x, g->mouse_state.y);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    glEnable(GL_DEPTH_TEST);
-    glClearColor(89.0/255.0, 219.0/255.0, 1.0, 1.0);
-
-    shader_block_init(&g->shader_block);
-    shader_selector_init(&g->shader_selector);
-}
-
-void game_process_input(game *g) 
-{
-    if (glfwWindowShouldClose(g->window)) {
-        g->running = false;
-        return;
-    }
-    if (glfwGetKey(g->window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetInputMode(g->window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-        g->mouse_state.in_game = false;
-    }
-    if (glfwGetMouseButton(g->window, GLFW_MOUSE_BUTTON_1) == GLFW_PRESS) {
-        glfwSetInputMode(g->window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-        g->mouse_state.in_game = true;
-        glfwGetCursorPos(g->window, &g->mouse_state.x, &g->mouse_state.y);
-    }
-    if (!g->mouse_state.in_game) return;
-    float speed = 0.2;
-    if (glfwGetKey(g->window, GLFW_KEY_W) == GLFW_PRESS) {
-        camera_move_forward(&g->camera, speed);
-    }
-    if (glfwGetKey(g->window, GLFW_KEY_S) == GLFW_PRESS) {
-        camera_move_backward(&g->camera, speed);
-    }
-    if (glfwGetKey(g->window, GLFW_KEY_A) == GLFW_PRESS) {
-        camera_move_left(&g->camera, speed);
-    }
-    if (glfwGetKey(g->window, GLFW_KEY_D) == GLFW_PRESS) {
-        camera_move_right(&g->camera, speed);
-    }
-    if (glfwGetKey(g->window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-        camera_move_up(&g->camera, speed);
-    }
-    if (glfwGetKey(g->window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) {
-        camera_move_down(&g->camera, speed);
-    }
-    double last_m_x = g->mouse_state.x, last_m_y = g->mouse_state.y;
-    glfwGetCursorPos(g->window, &g->mouse_state.x, &g->mouse_state.y);
-    float x_offset = (g->mouse_state.x - last_m_x);
-    float y_offset = -(g->mouse_state.y - last_m_y);
-    float sensitivity = 0.25;
-    x_offset *= sensitivity;
-    y_offset *= sensitivity;
-    float pitch = g->camera.pitch, yaw = g->camera.yaw;
-    pitch += y_offset;
-    yaw += x_offset;
-    camera_set_yaw_pitch(&g->camera, yaw, pitch);
-    //printf("\r(%f, %f, %f) (%f, %f)", g->camera.pos.x, g->camera.pos.y, g->camera.pos.z, g->camera.yaw, g->camera.pitch);
-    camera_update_view_matrix(&g->camera);
-}
-
-void game_update(game *g)
-{
-
-}
-
-void game_render(game *g, float alpha) 
-{
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_DEPTH_TEST);
-    shader_block_use(&g->shader_block);
-    world_render(&g->world, &g->camera, &g->shader_block);        
-    model_render(&g->model, &(vec3){30, 61, 30}, &g->camera, &g->shader_block, g->current_time);
-
-    block_type b;
-    ubpos pos = world_ray_cast(&g->world, &g->camera, 6, &b);
-    shader_selector_use(&g->shader_selector);
-    if (b != BLOCK_AIR) {
-        selector_render(&g->selector, &(vec3){pos.x, pos.y, pos.z}, &g->camera, &g->shader_selector);
-    }
-    glDisable(GL_DEPTH_TEST);
-    selector_render_cursor(&g->selector, &g->shader_selector);
-}
-
-void game_run(game *g)
-{
-    while (g->running)
-    {
-        glfwPollEvents();
-
-        double new_time = glfwGetTime();
-        double delta = new_time - g->current_time;
-        g->current_time = new_time;
-        g->accumulator += delta;
-
-        game_process_input(g);
-        while (g->accumulator >= TIME_PER_TICK) {
-            game_update(g);
-            g->accumulator -= TIME_PER_TICK;
-        }
-
-        float alpha = TIME_PER_TICK / g->accumulator;
-
-        game_render(g, alpha);
-        glfwSwapBuffers(g->window);
-    }
-}
-
-void game_end(game *g)
-{
-    g->running = false;
+#include "game.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "util.h"
+
+void game_init(game *g, GLFWwindow *window, const char *save_dir)
+{
+    g->window = window;
+    g->current_time = 0;
+    g->last_frame_time = time_seconds();
+    g->accumulator = 0;
+    g->running = true;
+    world_init(&g->world);
+    if (save_dir != NULL && !world_open_save(&g->world, save_dir)) {
+        fprintf(stderr, "can't open save directory %s, the world won't be saved\n", save_dir);
+    }
+    model_init(&g->model);
+    selector_init(&g->selector);
+    mat4 proj_matrix;
+    mat4_init_perspective(&proj_matrix, rad_from_deg(100), 1024.0 / 800.0, 0.1, 1000);
+    camera_init_custom(&g->camera, &proj_matrix, &(vec3){30, 61, 30}, 0, 0);
+    g->mouse_state = (mouse_state){0, 0, true};
+    g->mesher_key_down = false;
+    g->mesher_switching = false;
+    g->batch_key_down = false;
+    g->batched = true;
+    g->cave_key_down = false;
+    g->cave_culling = false;
+    g->break_key_down = false;
+    g->record.file = NULL;
+    g->replay.file = NULL;
+    g->frame_count = 0;
+    g->frame_count_start = time_seconds();
+    if (window != NULL) {
+        glfwSetCursorPos(g->window, g->mouse_state.x, g->mouse_state.y);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(89.0/255.0, 219.0/255.0, 1.0, 1.0);
+
+    shader_block_init(&g->shader_block);
+    shader_chunk_init(&g->shader_chunk);
+    shader_selector_init(&g->shader_selector);
+}
+
+bool game_record_input(game *g, const char *path)
+{
+    return input_log_open_write(&g->record, path);
+}
+
+bool game_replay_input(game *g, const char *path)
+{
+    return input_log_open_read(&g->replay, path);
+}
+
+/*
+ * Cycles between meshers so their vertex counts and frame times can be compared.
+ * The average frame time printed is for the mesher that was active before the switch,
+ * the new mesher's stats are printed by game_report_mesher once the world has been remeshed.
+ */
+static void game_switch_mesher(game *g)
+{
+    double now = time_seconds();
+    double avg_frame_ms = g->frame_count == 0 ? 0 : (now - g->frame_count_start) * 1000 / g->frame_count;
+    chunk_mesher prev = chunk_get_mesher();
+    printf("%s mesher: %.3f ms/frame over %u frames\n", chunk_mesher_name(prev), avg_frame_ms, g->frame_count);
+
+    world_set_mesher(&g->world, (prev + 1) % CHUNK_MESHERS_COUNT);
+    g->mesher_switching = true;
+    g->mesher_switch_start = now;
+}
+
+static void game_report_mesher(game *g)
+{
+    if (!g->mesher_switching || g->world.meshes_pending != 0) return;
+
+    double now = time_seconds();
+    world_mesh_stats stats = world_get_mesh_stats(&g->world);
+    printf("%s mesher: %zu vertices (%zu bytes), %zu indices in %zu sections (%zu pages, %zu compactions), remeshed in %.1f ms\n",
+           chunk_mesher_name(chunk_get_mesher()), stats.vertices, stats.vertex_bytes, stats.indices, stats.sections,
+           stats.pages, stats.compactions, (now - g->mesher_switch_start) * 1000);
+    world_storage_stats storage = world_get_storage_stats(&g->world);
+    printf("%zu chunks: %.1f MB of blocks, %.1f MB uncompressed\n",
+           storage.chunks, storage.block_bytes / 1e6, storage.raw_block_bytes / 1e6);
+
+    g->mesher_switching = false;
+    g->frame_count = 0;
+    g->frame_count_start = now;
+}
+
+// toggles between batched and per section draws, printing the frame time and draw calls of the previous mode
+static void game_toggle_batched(game *g)
+{
+    double now = time_seconds();
+    double avg_frame_ms = g->frame_count == 0 ? 0 : (now - g->frame_count_start) * 1000 / g->frame_count;
+    printf("%s rendering: %.3f ms/frame over %u frames, %zu draw calls\n", g->batched ? "batched" : "per section",
+           avg_frame_ms, g->frame_count, g->world.meshes.draw_calls);
+
+    g->batched = !g->batched;
+    world_set_batched(&g->world, g->batched);
+    g->frame_count = 0;
+    g->frame_count_start = now;
+}
+
+// toggles drawing only the sections the camera could see through air, printing what the previous mode drew
+static void game_toggle_cave_culling(game *g)
+{
+    double now = time_seconds();
+    double avg_frame_ms = g->frame_count == 0 ? 0 : (now - g->frame_count_start) * 1000 / g->frame_count;
+    printf("cave culling %s: %.3f ms/frame over %u frames, %zu sections drawn\n", g->cave_culling ? "on" : "off",
+           avg_frame_ms, g->frame_count, g->world.meshes.meshes_drawn);
+
+    g->cave_culling = !g->cave_culling;
+    world_set_cave_culling(&g->world, g->cave_culling);
+    g->frame_count = 0;
+    g->frame_count_start = now;
+}
+
+static const int game_keys[INPUT_KEYS_COUNT] = {
+    [INPUT_KEY_ESCAPE]   = GLFW_KEY_ESCAPE,
+    [INPUT_KEY_FORWARD]  = GLFW_KEY_W,
+    [INPUT_KEY_BACKWARD] = GLFW_KEY_S,
+    [INPUT_KEY_LEFT]     = GLFW_KEY_A,
+    [INPUT_KEY_RIGHT]    = GLFW_KEY_D,
+    [INPUT_KEY_UP]       = GLFW_KEY_SPACE,
+    [INPUT_KEY_DOWN]     = GLFW_KEY_LEFT_SHIFT,
+    [INPUT_KEY_MESHER]   = GLFW_KEY_M,
+    [INPUT_KEY_BATCH]    = GLFW_KEY_B,
+    [INPUT_KEY_CAVE]     = GLFW_KEY_C,
+};
+
+static void game_poll_input(game *g, frame_input *in)
+{
+    double now = time_seconds();
+    in->delta = now - g->last_frame_time;
+    g->last_frame_time = now;
+    glfwGetCursorPos(g->window, &in->cursor_x, &in->cursor_y);
+    in->keys = 0;
+    for (int k = 0; k < INPUT_KEYS_COUNT; k++) {
+        in->keys |= (glfwGetKey(g->window, game_keys[k]) == GLFW_PRESS) << k;
+    }
+    in->mouse_down = glfwGetMouseButton(g->window, GLFW_MOUSE_BUTTON_1) == GLFW_PRESS;
+    in->close = glfwWindowShouldClose(g->window);
+}
+
+// reads the frame's input from the replay or the window, recording it. Returns false once the replay runs out.
+static bool game_next_input(game *g, frame_input *in)
+{
+    if (g->window != NULL) {
+        glfwPollEvents();
+    }
+    if (g->replay.file != NULL) {
+        if (!input_log_read(&g->replay, in)) return false;
+        // the window can still be closed while replaying
+        if (g->window != NULL && glfwWindowShouldClose(g->window)) in->close = true;
+    } else {
+        game_poll_input(g, in);
+    }
+    if (g->record.file != NULL) {
+        input_log_write(&g->record, in);
+    }
+    return true;
+}
+
+static void game_process_input(game *g, const frame_input *in)
+{
+    if (in->close) {
+        g->running = false;
+        return;
+    }
+    if (frame_input_key(in, INPUT_KEY_ESCAPE)) {
+        if (g->window != NULL) glfwSetInputMode(g->window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        g->mouse_state.in_game = false;
+    }
+    if (in->mouse_down) {
+        if (g->window != NULL) glfwSetInputMode(g->window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        // the click that grabs the cursor doesn't break anything
+        if (!g->mouse_state.in_game) g->break_key_down = true;
+        g->mouse_state.in_game = true;
+        g->mouse_state.x = in->cursor_x;
+        g->mouse_state.y = in->cursor_y;
+    }
+    if (!g->mouse_state.in_game) return;
+    bool break_key_down = in->mouse_down;
+    if (break_key_down && !g->break_key_down) {
+        block_type b;
+        double start = profiler_begin();
+        ubpos pos = world_ray_cast(&g->world, &g->camera, 6, &b);
+        profiler_end(PROFILE_ZONE_RAY_CAST, start);
+        if (b != BLOCK_AIR) {
+            world_setr_block(&g->world, (bpos){pos.x, pos.y, pos.z}, BLOCK_AIR);
+        }
+    }
+    g->break_key_down = break_key_down;
+    bool mesher_key_down = frame_input_key(in, INPUT_KEY_MESHER);
+    if (mesher_key_down && !g->mesher_key_down) {
+        game_switch_mesher(g);
+    }
+    g->mesher_key_down = mesher_key_down;
+    bool batch_key_down = frame_input_key(in, INPUT_KEY_BATCH);
+    if (batch_key_down && !g->batch_key_down) {
+        game_toggle_batched(g);
+    }
+    g->batch_key_down = batch_key_down;
+    bool cave_key_down = frame_input_key(in, INPUT_KEY_CAVE);
+    if (cave_key_down && !g->cave_key_down) {
+        game_toggle_cave_culling(g);
+    }
+    g->cave_key_down = cave_key_down;
+    float speed = 0.2;
+    if (frame_input_key(in, INPUT_KEY_FORWARD)) {
+        camera_move_forward(&g->camera, speed);
+    }
+    if (frame_input_key(in, INPUT_KEY_BACKWARD)) {
+        camera_move_backward(&g->camera, speed);
+    }
+    if (frame_input_key(in, INPUT_KEY_LEFT)) {
+        camera_move_left(&g->camera, speed);
+    }
+    if (frame_input_key(in, INPUT_KEY_RIGHT)) {
+        camera_move_right(&g->camera, speed);
+    }
+    if (frame_input_key(in, INPUT_KEY_UP)) {
+        camera_move_up(&g->camera, speed);
+    }
+    if (frame_input_key(in, INPUT_KEY_DOWN)) {
+        camera_move_down(&g->camera, speed);
+    }
+    double last_m_x = g->mouse_state.x, last_m_y = g->mouse_state.y;
+    g->mouse_state.x = in->cursor_x;
+    g->mouse_state.y = in->cursor_y;
+    float x_offset = (g->mouse_state.x - last_m_x);
+    float y_offset = -(g->mouse_state.y - last_m_y);
+    float sensitivity = 0.25;
+    x_offset *= sensitivity;
+    y_offset *= sensitivity;
+    float pitch = g->camera.pitch, yaw = g->camera.yaw;
+    pitch += y_offset;
+    yaw += x_offset;
+    camera_set_yaw_pitch(&g->camera, yaw, pitch);
+    //printf("\r(%f, %f, %f) (%f, %f)", g->camera.pos.x, g->camera.pos.y, g->camera.pos.z, g->camera.yaw, g->camera.pitch);
+    camera_update_view_matrix(&g->camera);
+}
+
+void game_update(game *g)
+{
+    // every edit made since the last tick is remeshed together
+    world_flush_edits(&g->world);
+}
+
+void game_render(game *g, float alpha)
+{
+    double start = profiler_begin();
+    world_upload_meshes(&g->world);
+    profiler_end(PROFILE_ZONE_UPLOAD, start);
+    game_report_mesher(g);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+    start = profiler_begin();
+    profiler_gpu_begin(PROFILE_ZONE_GPU_WORLD);
+    shader_chunk_use(&g->shader_chunk);
+    world_render(&g->world, &g->camera, &g->shader_chunk);
+    profiler_gpu_end(PROFILE_ZONE_GPU_WORLD);
+    profiler_end(PROFILE_ZONE_WORLD_RENDER, start);
+
+    start = profiler_begin();
+    profiler_gpu_begin(PROFILE_ZONE_GPU_MODEL);
+    shader_block_use(&g->shader_block);
+    model_render(&g->model, &(vec3){30, 61, 30}, &g->camera, &g->shader_block, g->current_time);
+    profiler_gpu_end(PROFILE_ZONE_GPU_MODEL);
+    profiler_end(PROFILE_ZONE_MODEL_RENDER, start);
+
+    block_type b;
+    start = profiler_begin();
+    ubpos pos = world_ray_cast(&g->world, &g->camera, 6, &b);
+    profiler_end(PROFILE_ZONE_RAY_CAST, start);
+    profiler_gpu_begin(PROFILE_ZONE_GPU_SELECTOR);
+    shader_selector_use(&g->shader_selector);
+    if (b != BLOCK_AIR) {
+        selector_render(&g->selector, &(vec3){pos.x, pos.y, pos.z}, &g->camera, &g->shader_selector);
+    }
+    glDisable(GL_DEPTH_TEST);
+    selector_render_cursor(&g->selector, &g->shader_selector);
+    profiler_gpu_end(PROFILE_ZONE_GPU_SELECTOR);
+}
+
+// streams in every chunk within the load radius of the camera and waits for them to be meshed
+static void game_load_around_camera(game *g)
+{
+    world_stream(&g->world, &g->camera.pos, STREAM_BUDGET);
+    world_generate(&g->world);
+    while (g->world.meshes_pending > 0) {
+        world_upload_meshes(&g->world);
+    }
+}
+
+// prints where the replay left the camera and the world, to compare runs
+static void game_report_replay(game *g)
+{
+    printf("replayed %zu frames in %.3f s of game time, camera at (%.3f, %.3f, %.3f) yaw %.3f pitch %.3f, "
+           "world checksum %016llx\n", g->replay.frames, g->current_time, g->camera.pos.x, g->camera.pos.y,
+           g->camera.pos.z, g->camera.yaw, g->camera.pitch, (unsigned long long)world_checksum(&g->world));
+}
+
+void game_run(game *g)
+{
+    while (g->running)
+    {
+        frame_input in;
+        if (!game_next_input(g, &in)) break;
+        g->current_time += in.delta;
+        g->accumulator += in.delta;
+
+        double frame_start = profiler_begin();
+        double start = profiler_begin();
+        game_process_input(g, &in);
+        profiler_end(PROFILE_ZONE_INPUT, start);
+        start = profiler_begin();
+        if (g->window == NULL) {
+            // how much streams in each frame depends on timing, headless runs load everything around the camera
+            game_load_around_camera(g);
+        } else {
+            world_stream(&g->world, &g->camera.pos, STREAM_BUDGET);
+        }
+        profiler_end(PROFILE_ZONE_STREAM, start);
+        while (g->accumulator >= TIME_PER_TICK) {
+            start = profiler_begin();
+            game_update(g);
+            profiler_end(PROFILE_ZONE_UPDATE, start);
+            g->accumulator -= TIME_PER_TICK;
+        }
+
+        float alpha = TIME_PER_TICK / g->accumulator;
+
+        game_render(g, alpha);
+        if (g->window != NULL) {
+            glfwSwapBuffers(g->window);
+        }
+        profiler_end(PROFILE_ZONE_FRAME, frame_start);
+        profiler_collect();
+        g->frame_count++;
+    }
+    if (g->replay.file != NULL) {
+        game_report_replay(g);
+    }
+}
+
+/*
+ * The flythrough's path, as x, y, z, yaw and pitch at evenly spaced times. It circles the spawn above the terrain,
+ * then rises above it to look down and dives towards the ground.
+ */
+static const float flythrough_path[][5] = {
+    { 30,  90, -50, -90, -20},
+    {110,  85,  30,   0, -15},
+    { 30,  80, 110,  90, -25},
+    {-50,  95,  30, 180, -20},
+    { 30,  90, -50, 270, -20},
+    { 30, 110,  30, 300, -70},
+    { 30,  75,  30, 360, -10},
+};
+
+static float catmull_rom(float p0, float p1, float p2, float p3, float t)
+{
+    return 0.5f * (2 * p1 + (p2 - p0) * t + (2 * p0 - 5 * p1 + 4 * p2 - p3) * t * t
+                   + (3 * p1 - p0 - 3 * p2 + p3) * t * t * t);
+}
+
+// the point of the path at u, from 0 at its start to 1 at its end, on a Catmull-Rom spline through its points
+static void game_flythrough_point(float u, float point[5])
+{
+    int last = ARRAY_SIZE(flythrough_path) - 1;
+    float s = u * last;
+    int i = s < last ? (int)s : last - 1;
+    float t = s - i;
+    // the ends are repeated to give their segments a neighbour on both sides
+    const float *p0 = flythrough_path[i > 0 ? i - 1 : 0];
+    const float *p1 = flythrough_path[i];
+    const float *p2 = flythrough_path[i + 1];
+    const float *p3 = flythrough_path[i + 2 <= last ? i + 2 : last];
+    for (int k = 0; k < 5; k++) {
+        point[k] = catmull_rom(p0[k], p1[k], p2[k], p3[k], t);
+    }
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void game_flythrough_frame(game *g, float u)
+{
+    float p[5];
+    game_flythrough_point(u, p);
+    g->camera.pos = (vec3){p[0], p[1], p[2]};
+    camera_set_yaw_pitch(&g->camera, p[3], p[4]);
+    camera_update_view_matrix(&g->camera);
+    // loaded before the frame is timed, so every run draws the same world
+    game_load_around_camera(g);
+    g->current_time += FLYTHROUGH_FRAME_TIME;
+}
+
+bool game_run_flythrough(game *g, unsigned frames)
+{
+    for (unsigned i = 0; i < FLYTHROUGH_WARMUP_FRAMES; i++) {
+        game_flythrough_frame(g, 0);
+        game_render(g, 0);
+        glFinish();
+    }
+
+    double *frame_times = malloc(frames * sizeof(*frame_times));
+    size_t draw_calls = 0, triangles = 0, drawn = 0, culled = 0;
+    for (unsigned i = 0; i < frames; i++) {
+        game_flythrough_frame(g, frames > 1 ? (float)i / (frames - 1) : 0);
+        double start = time_seconds();
+        game_render(g, 0);
+        if (g->window != NULL) {
+            glfwSwapBuffers(g->window);
+        }
+        // waits for the GPU, or llvmpipe's threads, so the frame's rendering is counted in its time
+        glFinish();
+        frame_times[i] = time_seconds() - start;
+        profiler_collect();
+        g->frame_count++;
+
+        const mesh_buffer *meshes = &g->world.meshes;
+        draw_calls += meshes->draw_calls;
+        triangles += meshes->indices_drawn / 3;
+        drawn += meshes->meshes_drawn;
+        culled += world_get_mesh_stats(&g->world).sections - meshes->meshes_drawn;
+    }
+
+    double sum = 0;
+    for (unsigned i = 0; i < frames; i++) {
+        sum += frame_times[i];
+    }
+    qsort(frame_times, frames, sizeof(*frame_times), compare_doubles);
+    printf("flythrough: %u frames, ms/frame min %.3f avg %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f\n", frames,
+           frame_times[0] * 1000, sum / frames * 1000, frame_times[(frames - 1) / 2] * 1000,
+           frame_times[(frames - 1) * 90 / 100] * 1000, frame_times[(frames - 1) * 99 / 100] * 1000,
+           frame_times[frames - 1] * 1000);
+    printf("flythrough: per frame %.1f draw calls, %.0f triangles, %.1f sections drawn, %.1f sections culled\n",
+           (double)draw_calls / frames, (double)triangles / frames, (double)drawn / frames, (double)culled / frames);
+    free(frame_times);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        fprintf(stderr, "GL error 0x%x during the flythrough\n", error);
+        return false;
+    }
+    return true;
+}
+
+void game_end(game *g)
+{
+    g->running = false;
+}
+
+// prints the time generating chunks spent in each stage of the terrain pipeline
+static void game_report_terrain(game *g)
+{
+    terrain_stats stats = terrain_get_stats(&g->world.terrain);
+    if (stats.chunks == 0) return;
+    printf("%zu chunks generated, %zu heightmaps built, %zu reused:", stats.chunks, stats.heightmaps_built,
+           stats.heightmap_hits);
+    for (int s = 0; s < TERRAIN_STAGES_COUNT; s++) {
+        printf(" %s %.1f us", terrain_stage_names[s], stats.seconds[s] * 1e6 / stats.chunks);
+    }
+    printf(" per chunk\n");
+}
+
+void game_destroy(game *g)
+{
+    game_report_terrain(g);
+    input_log_close(&g->record);
+    input_log_close(&g->replay);
+    world_destroy(&g->world);
+    model_destroy(&g->model);
 }
\ No newline at end of file
@@ -1,41 +1,88 @@
-#pragma once
-
-#include "glad.h"
-#include <GLFW/glfw3.h>
-#include "world.h"
-#include "model.h"
-#include "camera.h"
-#include <stdbool.h>
-#include "cgmath.h"
-#include "block.h"
-#include "shaders/shader_block.h"
-#include "shaders/shader_selector.h"
-
-#define TICKS_PER_SEC 20
-#define TIME_PER_TICK (1.0 / TICKS_PER_SEC)
-
-typedef struct mouse_state {
-    double x;
-    double y;
-    bool   in_game;
-} mouse_state;
-
-typedef struct game {
-    GLFWwindow      *window;
-    double          current_time;
-    double          accumulator;
-    bool            running;
-    world           world;
-    model           model;
-    selector        selector;
-    camera          camera;
-    mouse_state     mouse_state;
-
-    shader_block    shader_block;
-    shader_selector shader_selector;
-} game;
-
-void game_init(game *g, GLFWwindow *window);
-void game_run(game *g);
-// called within gameloop to end
-void game_end(game *g);
\ No newline at end of file
+#pragma once
+
+#include "glad.h"
+#include <GLFW/glfw3.h>
+#include "world.h"
+#include "model.h"
+#include "camera.h"
+#include <stdbool.h>
+#include "cgmath.h"
+#include "block.h"
+#include "shaders/shader_block.h"
+#include "shaders/shader_chunk.h"
+#include "shaders/shader_selector.h"
+#include "input.h"
+
+#define TICKS_PER_SEC 20
+#define TIME_PER_TICK (1.0 / TICKS_PER_SEC)
+// seconds of chunk generation allowed per frame
+#define STREAM_BUDGET 0.004
+// game time the flythrough advances each frame, and frames rendered before it starts timing
+#define FLYTHROUGH_FRAME_TIME    (1.0 / 60)
+#define FLYTHROUGH_WARMUP_FRAMES 10
+
+typedef struct mouse_state {
+    double x;
+    double y;
+    bool   in_game;
+} mouse_state;
+
+typedef struct game {
+    // NULL if headless
+    GLFWwindow      *window;
+    // game time, the sum of every frame's delta
+    double          current_time;
+    // wall clock time the last live frame started at
+    double          last_frame_time;
+    double          accumulator;
+    bool            running;
+    world           world;
+    model           model;
+    selector        selector;
+    camera          camera;
+    mouse_state     mouse_state;
+    // edge detection for the mesher toggle key
+    bool            mesher_key_down;
+    // set while the world is being remeshed after a mesher switch
+    bool            mesher_switching;
+    double          mesher_switch_start;
+    // edge detection for the batched rendering toggle key
+    bool            batch_key_down;
+    bool            batched;
+    // edge detection for the cave culling toggle key
+    bool            cave_key_down;
+    bool            cave_culling;
+    // edge detection for breaking blocks, so holding the button breaks one
+    bool            break_key_down;
+    // each frame's input is written to record if it's open, and read from replay instead of the window if it's open
+    input_log       record;
+    input_log       replay;
+    // frames rendered since frame_count_start, for average frame times
+    unsigned        frame_count;
+    double          frame_count_start;
+
+    shader_block    shader_block;
+    shader_chunk    shader_chunk;
+    shader_selector shader_selector;
+} game;
+
+/*
+ * save_dir can be NULL to not save the world.
+ * window can be NULL to run headless, replaying input and rendering through a stubbed out GL. Headless frames 
+ * wait for the world around the camera to be loaded, so replays end in the same world every time.
+ */
+void game_init(game *g, GLFWwindow *window, const char *save_dir);
+// records every frame's input to path. Returns false if it can't be created.
+bool game_record_input(game *g, const char *path);
+// replays input recorded to path instead of reading the window, ending the game once it runs out
+bool game_replay_input(game *g, const char *path);
+void game_run(game *g);
+/*
+ * Flies the camera along a fixed path for frames frames instead of reading input, then prints frame time 
+ * percentiles and what was drawn per frame. The world around the camera is loaded before each frame is timed.
+ * Returns false if GL reported an error.
+ */
+bool game_run_flythrough(game *g, unsigned frames);
+// called within gameloop to end
+void game_end(game *g);
+void game_destroy(game *g);
\ No newline at end of file
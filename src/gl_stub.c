@@ -0,0 +1,103 @@
+#include "gl_stub.h"
+
+// object names are never reused, so code tracking GL objects sees distinct ones
+static GLuint next_name = 1;
+
+static void APIENTRY stub_gen(GLsizei n, GLuint *names)
+{
+    for (GLsizei i = 0; i < n; i++) {
+        names[i] = next_name++;
+    }
+}
+
+static GLuint APIENTRY stub_create(void) { return next_name++; }
+static GLuint APIENTRY stub_create_shader(GLenum type) { return next_name++; }
+static void APIENTRY stub_delete(GLsizei n, const GLuint *names) {}
+static void APIENTRY stub_delete_object(GLuint name) {}
+static void APIENTRY stub_bind(GLenum target, GLuint name) {}
+static void APIENTRY stub_bind_vertex_array(GLuint name) {}
+static void APIENTRY stub_buffer_data(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {}
+static void APIENTRY stub_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {}
+static void APIENTRY stub_copy_buffer_sub_data(GLenum read_target, GLenum write_target, GLintptr read_offset, GLintptr write_offset, GLsizeiptr size) {}
+static void APIENTRY stub_vertex_attrib_pointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) {}
+static void APIENTRY stub_vertex_attrib_i_pointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer) {}
+static void APIENTRY stub_index(GLuint index) {}
+static void APIENTRY stub_cap(GLenum cap) {}
+static void APIENTRY stub_uniform_matrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {}
+static void APIENTRY stub_uniform1i(GLint location, GLint v0) {}
+static void APIENTRY stub_uniform2f(GLint location, GLfloat v0, GLfloat v1) {}
+static GLint APIENTRY stub_get_uniform_location(GLuint program, const GLchar *name) { return 0; }
+static void APIENTRY stub_draw_elements(GLenum mode, GLsizei count, GLenum type, const void *indices) {}
+static void APIENTRY stub_draw_elements_base_vertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex) {}
+static void APIENTRY stub_multi_draw_elements_base_vertex(GLenum mode, const GLsizei *count, GLenum type, const void *const *indices, GLsizei drawcount, const GLint *basevertex) {}
+static void APIENTRY stub_draw_arrays(GLenum mode, GLint first, GLsizei count) {}
+static void APIENTRY stub_tex_parameteri(GLenum target, GLenum pname, GLint param) {}
+static void APIENTRY stub_tex_buffer(GLenum target, GLenum internalformat, GLuint buffer) {}
+static void APIENTRY stub_tex_image_2d(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) {}
+static void APIENTRY stub_shader_source(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length) {}
+static void APIENTRY stub_attach(GLuint program, GLuint shader) {}
+static void APIENTRY stub_get_iv(GLuint object, GLenum pname, GLint *params) { *params = GL_TRUE; }
+static GLenum APIENTRY stub_get_error(void) { return GL_NO_ERROR; }
+static void APIENTRY stub_clear(GLbitfield mask) {}
+static void APIENTRY stub_clear_color(GLfloat r, GLfloat g, GLfloat b, GLfloat a) {}
+static void APIENTRY stub_point_size(GLfloat size) {}
+static void APIENTRY stub_finish(void) {}
+static void APIENTRY stub_begin_query(GLenum target, GLuint id) {}
+static void APIENTRY stub_end_query(GLenum target) {}
+static void APIENTRY stub_get_query_object_ui64v(GLuint id, GLenum pname, GLuint64 *params) { *params = 0; }
+
+void gl_stub_init(void)
+{
+    glad_glGenBuffers = stub_gen;
+    glad_glGenVertexArrays = stub_gen;
+    glad_glGenTextures = stub_gen;
+    glad_glCreateProgram = stub_create;
+    glad_glCreateShader = stub_create_shader;
+    glad_glDeleteBuffers = stub_delete;
+    glad_glDeleteVertexArrays = stub_delete;
+    glad_glDeleteTextures = stub_delete;
+    glad_glDeleteShader = stub_delete_object;
+    glad_glUseProgram = stub_delete_object;
+    glad_glCompileShader = stub_delete_object;
+    glad_glLinkProgram = stub_delete_object;
+    glad_glBindBuffer = stub_bind;
+    glad_glBindTexture = stub_bind;
+    glad_glBindVertexArray = stub_bind_vertex_array;
+    glad_glBufferData = stub_buffer_data;
+    glad_glBufferSubData = stub_buffer_sub_data;
+    glad_glCopyBufferSubData = stub_copy_buffer_sub_data;
+    glad_glVertexAttribPointer = stub_vertex_attrib_pointer;
+    glad_glVertexAttribIPointer = stub_vertex_attrib_i_pointer;
+    glad_glEnableVertexAttribArray = stub_index;
+    glad_glEnable = stub_cap;
+    glad_glDisable = stub_cap;
+    glad_glActiveTexture = stub_cap;
+    glad_glGenerateMipmap = stub_cap;
+    glad_glUniformMatrix4fv = stub_uniform_matrix4fv;
+    glad_glUniform1i = stub_uniform1i;
+    glad_glUniform2f = stub_uniform2f;
+    glad_glGetUniformLocation = stub_get_uniform_location;
+    glad_glDrawElements = stub_draw_elements;
+    glad_glDrawElementsBaseVertex = stub_draw_elements_base_vertex;
+    glad_glMultiDrawElementsBaseVertex = stub_multi_draw_elements_base_vertex;
+    glad_glDrawArrays = stub_draw_arrays;
+    glad_glTexParameteri = stub_tex_parameteri;
+    glad_glTexImage2D = stub_tex_image_2d;
+    glad_glTexBuffer = stub_tex_buffer;
+    glad_glShaderSource = stub_shader_source;
+    glad_glAttachShader = stub_attach;
+    glad_glDetachShader = stub_attach;
+    glad_glGetShaderiv = stub_get_iv;
+    glad_glGetProgramiv = stub_get_iv;
+    glad_glGetError = stub_get_error;
+    glad_glClear = stub_clear;
+    glad_glClearColor = stub_clear_color;
+    glad_glPointSize = stub_point_size;
+    glad_glFinish = stub_finish;
+    glad_glGenQueries = stub_gen;
+    glad_glDeleteQueries = stub_delete;
+    glad_glBeginQuery = stub_begin_query;
+    glad_glEndQuery = stub_end_query;
+    glad_glGetQueryObjectiv = stub_get_iv;
+    glad_glGetQueryObjectui64v = stub_get_query_object_ui64v;
+}
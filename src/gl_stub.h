@@ -0,0 +1,10 @@
+/*
+ * Null GL backend for running without a context, by the benchmarks and the game's headless mode.
+ * Everything up to issuing GL calls runs as it would with a context, the calls themselves do nothing.
+ */
+#pragma once
+
+#include "glad.h"
+
+// points the GL functions the game uses at stubs that succeed without a context
+void gl_stub_init(void);
@@ -0,0 +1,80 @@
+#include "input.h"
+#include <string.h>
+
+#define INPUT_LOG_MAGIC   "MKIN"
+#define INPUT_LOG_VERSION 1
+
+typedef struct input_log_header {
+    char     magic[4];
+    uint32_t version;
+} input_log_header;
+
+// frames are written field by field, as frame_input is padded
+enum { INPUT_FLAG_MOUSE_DOWN = 1, INPUT_FLAG_CLOSE = 2 };
+
+bool frame_input_key(const frame_input *in, input_key k)
+{
+    return in->keys >> k & 1;
+}
+
+bool input_log_open_write(input_log *l, const char *path)
+{
+    l->frames = 0;
+    l->file = fopen(path, "wb");
+    if (l->file == NULL) return false;
+    input_log_header header = {INPUT_LOG_MAGIC, INPUT_LOG_VERSION};
+    fwrite(&header, sizeof(header), 1, l->file);
+    return true;
+}
+
+bool input_log_open_read(input_log *l, const char *path)
+{
+    l->frames = 0;
+    l->file = fopen(path, "rb");
+    if (l->file == NULL) return false;
+    input_log_header header;
+    if (fread(&header, sizeof(header), 1, l->file) != 1
+        || memcmp(header.magic, INPUT_LOG_MAGIC, sizeof(header.magic)) != 0
+        || header.version != INPUT_LOG_VERSION) {
+        fclose(l->file);
+        l->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+void input_log_write(input_log *l, const frame_input *in)
+{
+    uint8_t flags = (in->mouse_down ? INPUT_FLAG_MOUSE_DOWN : 0) | (in->close ? INPUT_FLAG_CLOSE : 0);
+    fwrite(&in->delta, sizeof(in->delta), 1, l->file);
+    fwrite(&in->cursor_x, sizeof(in->cursor_x), 1, l->file);
+    fwrite(&in->cursor_y, sizeof(in->cursor_y), 1, l->file);
+    fwrite(&in->keys, sizeof(in->keys), 1, l->file);
+    fwrite(&flags, sizeof(flags), 1, l->file);
+    l->frames++;
+}
+
+bool input_log_read(input_log *l, frame_input *in)
+{
+    uint8_t flags;
+    // a frame cut short by a crash while recording is dropped
+    if (fread(&in->delta, sizeof(in->delta), 1, l->file) != 1
+        || fread(&in->cursor_x, sizeof(in->cursor_x), 1, l->file) != 1
+        || fread(&in->cursor_y, sizeof(in->cursor_y), 1, l->file) != 1
+        || fread(&in->keys, sizeof(in->keys), 1, l->file) != 1
+        || fread(&flags, sizeof(flags), 1, l->file) != 1) {
+        return false;
+    }
+    in->mouse_down = flags & INPUT_FLAG_MOUSE_DOWN;
+    in->close = flags & INPUT_FLAG_CLOSE;
+    l->frames++;
+    return true;
+}
+
+void input_log_close(input_log *l)
+{
+    if (l->file != NULL) {
+        fclose(l->file);
+        l->file = NULL;
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * Input the game reads each frame, gathered up front so frames can be recorded to a log and replayed later.
+ * A log is a header followed by a record per frame, in native byte order like region files.
+ * Replaying a log feeds the game the same inputs and frame times as the recorded run, so the camera takes the
+ * same path through the world. The world itself only matches if it streams in the same, as it does headless.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef enum input_key {
+    INPUT_KEY_ESCAPE,
+    INPUT_KEY_FORWARD,
+    INPUT_KEY_BACKWARD,
+    INPUT_KEY_LEFT,
+    INPUT_KEY_RIGHT,
+    INPUT_KEY_UP,
+    INPUT_KEY_DOWN,
+    INPUT_KEY_MESHER,
+    INPUT_KEY_BATCH,
+    INPUT_KEY_CAVE,
+
+    INPUT_KEYS_COUNT,
+} input_key;
+
+typedef struct frame_input {
+    // seconds since the last frame
+    double   delta;
+    double   cursor_x;
+    double   cursor_y;
+    // bit per input_key held down
+    uint16_t keys;
+    bool     mouse_down;
+    // the window was asked to close
+    bool     close;
+} frame_input;
+
+typedef struct input_log {
+    FILE   *file;
+    // frames written or read so far
+    size_t frames;
+} input_log;
+
+bool frame_input_key(const frame_input *in, input_key k);
+// creates or truncates the log at path. Returns false if it can't be created.
+bool input_log_open_write(input_log *l, const char *path);
+// returns false if path can't be read or isn't an input log
+bool input_log_open_read(input_log *l, const char *path);
+void input_log_write(input_log *l, const frame_input *in);
+// returns false once every frame has been read
+bool input_log_read(input_log *l, frame_input *in);
+void input_log_close(input_log *l);
@@ -1,42 +1,121 @@
-#include "glad.h"
-#include <GLFW/glfw3.h>
-#include <stdbool.h>
-#include "util.h"
-#include "game.h"
-#include "stb_image.h"
-
-void error_callback(int error, const char *desc)
-{
-    panic("%s", desc);
-}
-
-void framebuffer_size_callback(GLFWwindow *window, int width, int height)
-{
-    glViewport(0, 0, width, height);
-}
-
-int main() 
-{
-    glfwSetErrorCallback(error_callback);
-    glfwInit();
-    stbi_set_flip_vertically_on_load(true);
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    GLFWwindow *window = glfwCreateWindow(1024, 800, "Meincraft", NULL, NULL);
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(0);
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-        panic("%s", "GLAD initialization failure");
-
-    glViewport(0, 0, 1024, 800);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-
-    game game;
-    game_init(&game, window);
-    game_run(&game);
-
-    glfwTerminate();
-    return 0;
-}
+#include "glad.h"
+#include <GLFW/glfw3.h>
+#include <stdbool.h>
+#include "util.h"
+#include "game.h"
+#include "stb_image.h"
+#include "profiler.h"
+#include "gl_stub.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void error_callback(int error, const char *desc)
+{
+    panic("%s", desc);
+}
+
+void framebuffer_size_callback(GLFWwindow *window, int width, int height)
+{
+    glViewport(0, 0, width, height);
+}
+
+/*
+ * The world is saved in the directory given as an argument, or in "save". Options:
+ * --profile             times zones of every frame, printing a summary of each on exit
+ * --trace <file>        profiles as --profile does, also writing a Chrome trace of every zone to file
+ * --record <file>       records every frame's input to file
+ * --replay <file>       replays input recorded to file, exiting once it runs out
+ * --flythrough <frames> flies the camera along a fixed path instead of reading input, printing frame times and
+ *                       what was drawn. The world isn't saved unless a directory is given.
+ * --headless            runs a replay or flythrough without a window or GL. The world isn't saved unless a
+ *                       directory is given.
+ */
+int main(int argc, char **argv) 
+{
+    const char *save_dir = NULL;
+    const char *trace_path = NULL;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    unsigned flythrough_frames = 0;
+    bool headless = false;
+    bool profile = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+            profile = true;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--flythrough") == 0 && i + 1 < argc) {
+            flythrough_frames = strtoul(argv[++i], NULL, 10);
+            if (flythrough_frames == 0) {
+                fprintf(stderr, "--flythrough needs a number of frames\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else {
+            save_dir = argv[i];
+        }
+    }
+    if (headless && replay_path == NULL && flythrough_frames == 0) {
+        fprintf(stderr, "--headless needs input to --replay or a --flythrough\n");
+        return 1;
+    }
+
+    stbi_set_flip_vertically_on_load(true);
+    GLFWwindow *window = NULL;
+    if (headless) {
+        gl_stub_init();
+    } else {
+        // a flythrough shouldn't change the world it's timed against
+        if (save_dir == NULL && flythrough_frames == 0) save_dir = "save";
+        glfwSetErrorCallback(error_callback);
+        glfwInit();
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        window = glfwCreateWindow(1024, 800, "Meincraft", NULL, NULL);
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+            panic("%s", "GLAD initialization failure");
+
+        glViewport(0, 0, 1024, 800);
+        if (flythrough_frames > 0) {
+            printf("%s, %s\n", glGetString(GL_VERSION), glGetString(GL_RENDERER));
+        }
+        glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    }
+
+    // started before the game so the workers see it enabled. It keeps every timing, so it's only on when asked for
+    if (profile && !profiler_init(trace_path)) {
+        fprintf(stderr, "can't open trace file %s, profiling without it\n", trace_path);
+    }
+    game game;
+    game_init(&game, window, save_dir);
+    if (record_path != NULL && !game_record_input(&game, record_path)) {
+        fprintf(stderr, "can't create input log %s, input won't be recorded\n", record_path);
+    }
+    if (replay_path != NULL && !game_replay_input(&game, replay_path)) {
+        panic("can't read input log %s", replay_path);
+    }
+    bool ok = true;
+    if (flythrough_frames > 0) {
+        ok = game_run_flythrough(&game, flythrough_frames);
+    } else {
+        game_run(&game);
+    }
+    game_destroy(&game);
+    profiler_destroy();
+
+    if (!headless) {
+        glfwTerminate();
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,328 @@
+#include "mesh_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include "util.h"
+
+LIST_DEFINE(mesh_range)
+LIST_DEFINE(mesh_page_ptr)
+LIST_DEFINE(mesh_alloc_ptr)
+
+// takes len from the first free range that fits. Returns false if none does.
+static bool range_alloc(list_mesh_range *free_ranges, uint32_t len, uint32_t *start)
+{
+    for (size_t i = 0; i < free_ranges->len; i++) {
+        mesh_range *r = &free_ranges->data[i];
+        if (r->len < len) continue;
+        *start = r->start;
+        r->start += len;
+        r->len -= len;
+        if (r->len == 0) {
+            memmove(r, r + 1, (free_ranges->len - i - 1) * sizeof(*r));
+            free_ranges->len--;
+        }
+        return true;
+    }
+    return false;
+}
+
+// gives back the range, merging it with the free ranges it touches
+static void range_free(list_mesh_range *free_ranges, uint32_t start, uint32_t len)
+{
+    size_t i = 0;
+    while (i < free_ranges->len && free_ranges->data[i].start < start) i++;
+    mesh_range *prev = i > 0 ? &free_ranges->data[i - 1] : NULL;
+    mesh_range *next = i < free_ranges->len ? &free_ranges->data[i] : NULL;
+    bool joins_prev = prev != NULL && prev->start + prev->len == start;
+    bool joins_next = next != NULL && start + len == next->start;
+    if (joins_prev && joins_next) {
+        prev->len += len + next->len;
+        memmove(next, next + 1, (free_ranges->len - i - 1) * sizeof(*next));
+        free_ranges->len--;
+    } else if (joins_prev) {
+        prev->len += len;
+    } else if (joins_next) {
+        next->start = start;
+        next->len += len;
+    } else {
+        list_mesh_range_add(free_ranges);
+        mesh_range *r = &free_ranges->data[i];
+        memmove(r + 1, r, (free_ranges->len - i - 1) * sizeof(*r));
+        *r = (mesh_range){start, len};
+    }
+}
+
+static uint32_t range_total(const list_mesh_range *free_ranges, uint32_t *largest)
+{
+    uint32_t total = 0;
+    *largest = 0;
+    for (size_t i = 0; i < free_ranges->len; i++) {
+        uint32_t len = free_ranges->data[i].len;
+        total += len;
+        if (len > *largest) *largest = len;
+    }
+    return total;
+}
+
+// creates an empty vertex buffer for the page's VAO, leaving it bound
+static void mesh_page_create_vbo(mesh_page *p)
+{
+    glBindVertexArray(p->vao);
+    glGenBuffers(1, &p->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, p->vbo);
+    glBufferData(GL_ARRAY_BUFFER, MESH_PAGE_VERTICES * sizeof(shader_chunk_vertex), NULL, GL_DYNAMIC_DRAW);
+    shader_chunk_set_up_attributes();
+}
+
+static mesh_page *mesh_page_create(GLuint quad_ebo)
+{
+    mesh_page *p = malloc(sizeof(*p));
+    glGenVertexArrays(1, &p->vao);
+    mesh_page_create_vbo(p);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quad_ebo);
+    glBindVertexArray(0);
+
+    list_mesh_alloc_ptr_init(&p->allocs);
+    list_mesh_range_init(&p->free_vertices);
+    *list_mesh_range_add(&p->free_vertices) = (mesh_range){0, MESH_PAGE_VERTICES};
+    list_GLsizei_init(&p->counts);
+    list_gl_offset_init(&p->offsets);
+    list_GLint_init(&p->base_vertices);
+    return p;
+}
+
+static void mesh_page_destroy(mesh_page *p)
+{
+    glDeleteVertexArrays(1, &p->vao);
+    glDeleteBuffers(1, &p->vbo);
+    list_mesh_alloc_ptr_destroy(&p->allocs);
+    list_mesh_range_destroy(&p->free_vertices);
+    list_GLsizei_destroy(&p->counts);
+    list_gl_offset_destroy(&p->offsets);
+    list_GLint_destroy(&p->base_vertices);
+    free(p);
+}
+
+void mesh_buffer_init(mesh_buffer *b)
+{
+    list_mesh_page_ptr_init(&b->pages);
+    // the same two triangles for every quad, offset by the quad's first vertex
+    GLushort *quad_indices = malloc(MESH_QUAD_INDICES * sizeof(GLushort));
+    const GLushort face_indices[] = {block_face_indices(0)};
+    for (size_t i = 0; i < MESH_QUAD_INDICES; i++) {
+        size_t quad = i / BLOCK_FACE_INDICES_COUNT;
+        quad_indices[i] = quad * BLOCK_FACE_VERTICES_COUNT + face_indices[i % BLOCK_FACE_INDICES_COUNT];
+    }
+    glGenBuffers(1, &b->quad_ebo);
+    // element buffers are bound to the VAO, keep the current one untouched
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, b->quad_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, MESH_QUAD_INDICES * sizeof(GLushort), quad_indices, GL_STATIC_DRAW);
+    free(quad_indices);
+    glGenBuffers(1, &b->origins_buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, b->origins_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, MESH_BUFFER_SLOTS * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glGenTextures(1, &b->origins_texture);
+    glBindTexture(GL_TEXTURE_BUFFER, b->origins_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, b->origins_buffer);
+    list_GLuint_init(&b->free_slots);
+    b->slots_used = 0;
+    b->batched = true;
+    b->bound_vao = 0;
+    b->draw_calls = 0;
+    b->meshes_drawn = 0;
+    b->indices_drawn = 0;
+    b->compactions = 0;
+}
+
+void mesh_alloc_init(mesh_alloc *a)
+{
+    a->page = 0;
+    a->page_index = 0;
+    a->first_vertex = 0;
+    a->vertex_count = 0;
+    a->index_count = 0;
+    a->slot = 0;
+}
+
+static uint32_t mesh_buffer_take_slot(mesh_buffer *b)
+{
+    if (b->free_slots.len > 0) return b->free_slots.data[--b->free_slots.len];
+    if (b->slots_used == MESH_BUFFER_SLOTS) panic("out of mesh slots, %d sections have meshes", MESH_BUFFER_SLOTS);
+    return b->slots_used++;
+}
+
+void mesh_buffer_release(mesh_buffer *b, mesh_alloc *a)
+{
+    if (a->index_count == 0) return;
+    mesh_page *p = b->pages.data[a->page];
+    range_free(&p->free_vertices, a->first_vertex, a->vertex_count);
+    mesh_alloc *last = p->allocs.data[--p->allocs.len];
+    p->allocs.data[a->page_index] = last;
+    last->page_index = a->page_index;
+    *list_GLuint_add(&b->free_slots) = a->slot;
+    a->index_count = 0;
+    a->vertex_count = 0;
+}
+
+/*
+ * Moves every mesh of the page to the start of a fresh vertex buffer, merging all of its free space into one range.
+ * The copies stay on the GPU.
+ */
+static void mesh_page_compact(mesh_buffer *b, mesh_page *p)
+{
+    GLuint old_vbo = p->vbo;
+    mesh_page_create_vbo(p);
+    b->bound_vao = p->vao;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, old_vbo);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, p->vbo);
+    uint32_t top = 0;
+    for (size_t i = 0; i < p->allocs.len; i++) {
+        mesh_alloc *a = p->allocs.data[i];
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, a->first_vertex * sizeof(shader_chunk_vertex), 
+                            top * sizeof(shader_chunk_vertex), a->vertex_count * sizeof(shader_chunk_vertex));
+        a->first_vertex = top;
+        top += a->vertex_count;
+    }
+    glDeleteBuffers(1, &old_vbo);
+
+    list_mesh_range_clear(&p->free_vertices);
+    if (top < MESH_PAGE_VERTICES) {
+        *list_mesh_range_add(&p->free_vertices) = (mesh_range){top, MESH_PAGE_VERTICES - top};
+    }
+    b->compactions++;
+}
+
+static bool mesh_page_fragmented(const mesh_page *p)
+{
+    if (p->free_vertices.len <= MESH_PAGE_MAX_FREE_RANGES) return false;
+    uint32_t largest;
+    uint32_t free_vertices = range_total(&p->free_vertices, &largest);
+    return largest < free_vertices / 2;
+}
+
+// takes the range from the page, returning false if it doesn't have room
+static bool mesh_page_alloc(mesh_page *p, mesh_alloc *a, uint32_t vertex_count)
+{
+    if (!range_alloc(&p->free_vertices, vertex_count, &a->first_vertex)) return false;
+    a->vertex_count = vertex_count;
+    a->index_count = vertex_count / BLOCK_FACE_VERTICES_COUNT * BLOCK_FACE_INDICES_COUNT;
+    a->page_index = p->allocs.len;
+    *list_mesh_alloc_ptr_add(&p->allocs) = a;
+    return true;
+}
+
+// finds room for the mesh, compacting a page whose free space is enough but fragmented before adding a new page
+static uint32_t mesh_buffer_alloc(mesh_buffer *b, mesh_alloc *a, uint32_t vertex_count)
+{
+    for (uint32_t i = 0; i < b->pages.len; i++) {
+        if (mesh_page_alloc(b->pages.data[i], a, vertex_count)) return i;
+    }
+    for (uint32_t i = 0; i < b->pages.len; i++) {
+        mesh_page *p = b->pages.data[i];
+        uint32_t largest;
+        if (range_total(&p->free_vertices, &largest) < vertex_count) continue;
+        mesh_page_compact(b, p);
+        mesh_page_alloc(p, a, vertex_count);
+        return i;
+    }
+    *list_mesh_page_ptr_add(&b->pages) = mesh_page_create(b->quad_ebo);
+    mesh_page_alloc(b->pages.data[b->pages.len - 1], a, vertex_count);
+    return b->pages.len - 1;
+}
+
+void mesh_buffer_defragment(mesh_buffer *b)
+{
+    for (size_t i = 0; i < b->pages.len; i++) {
+        mesh_page *p = b->pages.data[i];
+        if (!mesh_page_fragmented(p)) continue;
+        mesh_page_compact(b, p);
+        return;
+    }
+}
+
+void mesh_buffer_upload(mesh_buffer *b, mesh_alloc *a, bpos origin, shader_chunk_vertex *vertices, size_t vertex_count)
+{
+    mesh_buffer_release(b, a);
+    if (vertex_count == 0) return;
+    if (vertex_count > MESH_MAX_VERTICES) {
+        panic("mesh of %zu vertices is more than the quad indices cover", vertex_count);
+    }
+
+    a->page = mesh_buffer_alloc(b, a, vertex_count);
+    a->slot = mesh_buffer_take_slot(b);
+
+    for (size_t i = 0; i < vertex_count; i++) {
+        vertices[i].b = (vertices[i].b & ~SHADER_CHUNK_SLOT_MASK) | a->slot << SHADER_CHUNK_SLOT_SHIFT;
+    }
+    float origin_v[4] = {origin.x, origin.y, origin.z, 0};
+    glBindBuffer(GL_TEXTURE_BUFFER, b->origins_buffer);
+    glBufferSubData(GL_TEXTURE_BUFFER, a->slot * sizeof(origin_v), sizeof(origin_v), origin_v);
+
+    mesh_page *p = b->pages.data[a->page];
+    glBindBuffer(GL_ARRAY_BUFFER, p->vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, a->first_vertex * sizeof(*vertices), vertex_count * sizeof(*vertices), vertices);
+}
+
+void mesh_buffer_begin(mesh_buffer *b)
+{
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_BUFFER, b->origins_texture);
+    glActiveTexture(GL_TEXTURE0);
+    b->bound_vao = 0;
+    b->draw_calls = 0;
+    b->meshes_drawn = 0;
+    b->indices_drawn = 0;
+}
+
+static void mesh_buffer_bind_page(mesh_buffer *b, const mesh_page *p)
+{
+    if (b->bound_vao == p->vao) return;
+    glBindVertexArray(p->vao);
+    b->bound_vao = p->vao;
+}
+
+void mesh_buffer_draw(mesh_buffer *b, const mesh_alloc *a)
+{
+    if (a->index_count == 0) return;
+    b->meshes_drawn++;
+    b->indices_drawn += a->index_count;
+    mesh_page *p = b->pages.data[a->page];
+    if (!b->batched) {
+        mesh_buffer_bind_page(b, p);
+        glDrawElementsBaseVertex(GL_TRIANGLES, a->index_count, GL_UNSIGNED_SHORT, NULL, a->first_vertex);
+        b->draw_calls++;
+        return;
+    }
+    // every mesh starts at the beginning of the quad indices
+    *list_GLsizei_add(&p->counts) = a->index_count;
+    *list_gl_offset_add(&p->offsets) = NULL;
+    *list_GLint_add(&p->base_vertices) = a->first_vertex;
+}
+
+void mesh_buffer_end(mesh_buffer *b)
+{
+    for (size_t i = 0; i < b->pages.len; i++) {
+        mesh_page *p = b->pages.data[i];
+        if (p->counts.len == 0) continue;
+        mesh_buffer_bind_page(b, p);
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, p->counts.data, GL_UNSIGNED_SHORT, p->offsets.data,
+                                      p->counts.len, p->base_vertices.data);
+        b->draw_calls++;
+        list_GLsizei_clear(&p->counts);
+        list_gl_offset_clear(&p->offsets);
+        list_GLint_clear(&p->base_vertices);
+    }
+}
+
+void mesh_buffer_destroy(mesh_buffer *b)
+{
+    for (size_t i = 0; i < b->pages.len; i++) {
+        mesh_page_destroy(b->pages.data[i]);
+    }
+    list_mesh_page_ptr_destroy(&b->pages);
+    glDeleteTextures(1, &b->origins_texture);
+    glDeleteBuffers(1, &b->origins_buffer);
+    glDeleteBuffers(1, &b->quad_ebo);
+    list_GLuint_destroy(&b->free_slots);
+}
@@ -0,0 +1,106 @@
+/*
+ * Shared GL buffers holding the meshes of every section, so the world can be drawn with a multi draw per page
+ * instead of binding a VAO and issuing a draw call per section.
+ * Meshes are sub allocated from pages, each a VAO with a vertex buffer. Ranges are handed out first fit from a 
+ * free list and updated with glBufferSubData. Meshes are made of quads, so instead of uploading indices every page 
+ * draws from one static buffer of 16 bit quad indices, with the mesh's first vertex as the base vertex. Pages are only created when no page has 
+ * room even after compaction, and a page whose free space gets broken into many small ranges is compacted by copying 
+ * its meshes into fresh buffers on the GPU, so streaming settles on a fixed set of buffers.
+ * Each mesh gets a slot, written into its vertices, which the vertex shader uses to look up the section's origin
+ * in a buffer texture. Sections are drawn with the same view projection matrix, without any per draw uniforms.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "glad.h"
+#include "pos.h"
+#include "block.h"
+#include "shaders/shader_chunk.h"
+#include "containers/list.h"
+#include "containers/gl_list.h"
+
+// vertices per mesh reachable by 16 bit indices, more than the worst case section (every other block set, meshed naively)
+#define MESH_MAX_VERTICES  (1 << 16)
+#define MESH_QUAD_INDICES  (MESH_MAX_VERTICES / BLOCK_FACE_VERTICES_COUNT * BLOCK_FACE_INDICES_COUNT)
+// vertices per page, room for many worst case sections
+#define MESH_PAGE_VERTICES (1 << 19)
+// slots are stored in 16 bits of the vertex
+#define MESH_BUFFER_SLOTS  (1 << 16)
+// a page is compacted once it has this many free vertex ranges and its largest is under half its free vertices
+#define MESH_PAGE_MAX_FREE_RANGES 64
+
+typedef struct mesh_range {
+    uint32_t start;
+    uint32_t len;
+} mesh_range;
+
+LIST_DECLARE(mesh_range)
+
+typedef struct mesh_alloc mesh_alloc;
+typedef mesh_alloc *mesh_alloc_ptr;
+LIST_DECLARE(mesh_alloc_ptr)
+
+typedef struct mesh_page {
+    GLuint          vao, vbo;
+    // the allocations in the page, so they can be moved when compacting
+    list_mesh_alloc_ptr allocs;
+    // unused ranges of vbo, sorted and coalesced
+    list_mesh_range free_vertices;
+    // draws queued for this frame's multi draw
+    list_GLsizei    counts;
+    list_gl_offset  offsets;
+    list_GLint      base_vertices;
+} mesh_page;
+
+typedef mesh_page *mesh_page_ptr;
+LIST_DECLARE(mesh_page_ptr)
+
+// where a section's mesh lives. index_count == 0 if it has none. Must stay at the same address while it has one.
+struct mesh_alloc {
+    uint32_t page;
+    // index in the page's allocs
+    uint32_t page_index;
+    uint32_t first_vertex, vertex_count;
+    // indices drawn from the quad indices
+    uint32_t index_count;
+    uint32_t slot;
+};
+
+typedef struct mesh_buffer {
+    list_mesh_page_ptr pages;
+    // indices of MESH_MAX_VERTICES / 4 quads, bound to every page's VAO
+    GLuint             quad_ebo;
+    // origin of the section using each slot, as a vec4 per slot
+    GLuint             origins_buffer;
+    GLuint             origins_texture;
+    list_GLuint        free_slots;
+    // slots above this have never been used
+    uint32_t           slots_used;
+    // multi draw per page if set, otherwise a draw call per section
+    bool               batched;
+    GLuint             bound_vao;
+    // draw calls issued, and meshes and indices drawn, since mesh_buffer_begin
+    size_t             draw_calls;
+    size_t             meshes_drawn;
+    size_t             indices_drawn;
+    // pages compacted so far
+    size_t             compactions;
+} mesh_buffer;
+
+void mesh_buffer_init(mesh_buffer *b);
+void mesh_alloc_init(mesh_alloc *a);
+/*
+ * Replaces the mesh in a with the given one, whose vertices are tagged with a's slot.
+ * Every 4 vertices are a quad, in the order of block_face_vertices.
+ */
+void mesh_buffer_upload(mesh_buffer *b, mesh_alloc *a, bpos origin, shader_chunk_vertex *vertices, size_t vertex_count);
+void mesh_buffer_release(mesh_buffer *b, mesh_alloc *a);
+// compacts at most one fragmented page, meant to be called once per frame
+void mesh_buffer_defragment(mesh_buffer *b);
+// binds the origins to texture unit 1 for the chunk shader
+void mesh_buffer_begin(mesh_buffer *b);
+// draws the mesh straight away, or queues it for mesh_buffer_end if batched
+void mesh_buffer_draw(mesh_buffer *b, const mesh_alloc *a);
+void mesh_buffer_end(mesh_buffer *b);
+void mesh_buffer_destroy(mesh_buffer *b);
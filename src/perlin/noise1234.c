@@ -1,522 +1,697 @@
-// noise1234
-//
-// Author: Stefan Gustavson, 2003-2005
-// Contact: stefan.gustavson@liu.se
-//
-// This code was GPL licensed until February 2011.
-// As the original author of this code, I hereby
-// release it into the public domain.
-// Please feel free to use it for whatever you want.
-// Credit is appreciated where appropriate, and I also
-// appreciate being told where this code finds any use,
-// but you may do as you like.
-
-/*
- * This implementation is "Improved Noise" as presented by
- * Ken Perlin at Siggraph 2002. The 3D function is a direct port
- * of his Java reference code which was once publicly available
- * on www.noisemachine.com (although I cleaned it up, made it
- * faster and made the code more readable), but the 1D, 2D and
- * 4D functions were implemented from scratch by me.
- *
- * This is a backport to C of my improved noise class in C++
- * which was included in the Aqsis renderer project.
- * It is highly reusable without source code modifications.
- *
- */
-
-#include "noise1234.h"
-
-// This is the new and improved, C(2) continuous interpolant
-#define FADE(t) ( t * t * t * ( t * ( t * 6 - 15 ) + 10 ) )
-
-#define FASTFLOOR(x) ( ((int)(x)<(x)) ? ((int)x) : ((int)x-1 ) )
-#define LERP(t, a, b) ((a) + (t)*((b)-(a)))
-
-
-//---------------------------------------------------------------------
-// Static data
-
-/*
- * Permutation table. This is just a random jumble of all numbers 0-255,
- * repeated twice to avoid wrapping the index at 255 for each lookup.
- * This needs to be exactly the same for all instances on all platforms,
- * so it's easiest to just keep it as static explicit data.
- * This also removes the need for any initialisation of this class.
- *
- * Note that making this an int[] instead of a char[] might make the
- * code run faster on platforms with a high penalty for unaligned single
- * byte addressing. Intel x86 is generally single-byte-friendly, but
- * some other CPUs are faster with 4-aligned reads.
- * However, a char[] is smaller, which avoids cache trashing, and that
- * is probably the most important aspect on most architectures.
- * This array is accessed a *lot* by the noise functions.
- * A vector-valued noise over 3D accesses it 96 times, and a
- * float-valued 4D noise 64 times. We want this to fit in the cache!
- */
-unsigned char perm[] = {151,160,137,91,90,15,
-  131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
-  190, 6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,
-  88,237,149,56,87,174,20,125,136,171,168, 68,175,74,165,71,134,139,48,27,166,
-  77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,55,46,245,40,244,
-  102,143,54, 65,25,63,161, 1,216,80,73,209,76,132,187,208, 89,18,169,200,196,
-  135,130,116,188,159,86,164,100,109,198,173,186, 3,64,52,217,226,250,124,123,
-  5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,
-  223,183,170,213,119,248,152, 2,44,154,163, 70,221,153,101,155,167, 43,172,9,
-  129,22,39,253, 19,98,108,110,79,113,224,232,178,185, 112,104,218,246,97,228,
-  251,34,242,193,238,210,144,12,191,179,162,241, 81,51,145,235,249,14,239,107,
-  49,192,214, 31,181,199,106,157,184, 84,204,176,115,121,50,45,127, 4,150,254,
-  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180,
-  151,160,137,91,90,15,
-  131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
-  190, 6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,
-  88,237,149,56,87,174,20,125,136,171,168, 68,175,74,165,71,134,139,48,27,166,
-  77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,55,46,245,40,244,
-  102,143,54, 65,25,63,161, 1,216,80,73,209,76,132,187,208, 89,18,169,200,196,
-  135,130,116,188,159,86,164,100,109,198,173,186, 3,64,52,217,226,250,124,123,
-  5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,
-  223,183,170,213,119,248,152, 2,44,154,163, 70,221,153,101,155,167, 43,172,9,
-  129,22,39,253, 19,98,108,110,79,113,224,232,178,185, 112,104,218,246,97,228,
-  251,34,242,193,238,210,144,12,191,179,162,241, 81,51,145,235,249,14,239,107,
-  49,192,214, 31,181,199,106,157,184, 84,204,176,115,121,50,45,127, 4,150,254,
-  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180
-};
-
-//---------------------------------------------------------------------
-
-/*
- * Helper functions to compute gradients-dot-residualvectors (1D to 4D)
- * Note that these generate gradients of more than unit length. To make
- * a close match with the value range of classic Perlin noise, the final
- * noise values need to be rescaled. To match the RenderMan noise in a
- * statistical sense, the approximate scaling values (empirically
- * determined from test renderings) are:
- * 1D noise needs rescaling with 0.188
- * 2D noise needs rescaling with 0.507
- * 3D noise needs rescaling with 0.936
- * 4D noise needs rescaling with 0.87
- * Note that these noise functions are the most practical and useful
- * signed version of Perlin noise. To return values according to the
- * RenderMan specification from the SL noise() and pnoise() functions,
- * the noise values need to be scaled and offset to [0,1], like this:
- * float SLnoise = (noise3(x,y,z) + 1.0) * 0.5;
- */
-
-static float grad1( int hash, float x ) {
-    int h = hash & 15;
-    float grad = 1.0 + (h & 7);  // Gradient value 1.0, 2.0, ..., 8.0
-    if (h&8) grad = -grad;         // and a random sign for the gradient
-    return ( grad * x );           // Multiply the gradient with the distance
-}
-
-static float grad2( int hash, float x, float y ) {
-    int h = hash & 7;      // Convert low 3 bits of hash code
-    float u = h<4 ? x : y;  // into 8 simple gradient directions,
-    float v = h<4 ? y : x;  // and compute the dot product with (x,y).
-    return ((h&1)? -u : u) + ((h&2)? -2.0*v : 2.0*v);
-}
-
-static float grad3( int hash, float x, float y , float z ) {
-    int h = hash & 15;     // Convert low 4 bits of hash code into 12 simple
-    float u = h<8 ? x : y; // gradient directions, and compute dot product.
-    float v = h<4 ? y : h==12||h==14 ? x : z; // Fix repeats at h = 12 to 15
-    return ((h&1)? -u : u) + ((h&2)? -v : v);
-}
-
-static float grad4( int hash, float x, float y, float z, float t ) {
-    int h = hash & 31;      // Convert low 5 bits of hash code into 32 simple
-    float u = h<24 ? x : y; // gradient directions, and compute dot product.
-    float v = h<16 ? y : z;
-    float w = h<8 ? z : t;
-    return ((h&1)? -u : u) + ((h&2)? -v : v) + ((h&4)? -w : w);
-}
-
-//---------------------------------------------------------------------
-/** 1D float Perlin noise, SL "noise()"
- */
-float noise1( float x )
-{
-    int ix0, ix1;
-    float fx0, fx1;
-    float s, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    fx0 = x - ix0;       // Fractional part of x
-    fx1 = fx0 - 1.0f;
-    ix1 = ( ix0+1 ) & 0xff;
-    ix0 = ix0 & 0xff;    // Wrap to 0..255
-
-    s = FADE( fx0 );
-
-    n0 = grad1( perm[ ix0 ], fx0 );
-    n1 = grad1( perm[ ix1 ], fx1 );
-    return 0.188f * ( LERP( s, n0, n1 ) );
-}
-
-//---------------------------------------------------------------------
-/** 1D float Perlin periodic noise, SL "pnoise()"
- */
-float pnoise1( float x, int px )
-{
-    int ix0, ix1;
-    float fx0, fx1;
-    float s, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    fx0 = x - ix0;       // Fractional part of x
-    fx1 = fx0 - 1.0f;
-    ix1 = (( ix0 + 1 ) % px) & 0xff; // Wrap to 0..px-1 *and* wrap to 0..255
-    ix0 = ( ix0 % px ) & 0xff;      // (because px might be greater than 256)
-
-    s = FADE( fx0 );
-
-    n0 = grad1( perm[ ix0 ], fx0 );
-    n1 = grad1( perm[ ix1 ], fx1 );
-    return 0.188f * ( LERP( s, n0, n1 ) );
-}
-
-
-//---------------------------------------------------------------------
-/** 2D float Perlin noise.
- */
-float noise2( float x, float y )
-{
-    int ix0, iy0, ix1, iy1;
-    float fx0, fy0, fx1, fy1;
-    float s, t, nx0, nx1, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    iy0 = FASTFLOOR( y ); // Integer part of y
-    fx0 = x - ix0;        // Fractional part of x
-    fy0 = y - iy0;        // Fractional part of y
-    fx1 = fx0 - 1.0f;
-    fy1 = fy0 - 1.0f;
-    ix1 = (ix0 + 1) & 0xff;  // Wrap to 0..255
-    iy1 = (iy0 + 1) & 0xff;
-    ix0 = ix0 & 0xff;
-    iy0 = iy0 & 0xff;
-    
-    t = FADE( fy0 );
-    s = FADE( fx0 );
-
-    nx0 = grad2(perm[ix0 + perm[iy0]], fx0, fy0);
-    nx1 = grad2(perm[ix0 + perm[iy1]], fx0, fy1);
-    n0 = LERP( t, nx0, nx1 );
-
-    nx0 = grad2(perm[ix1 + perm[iy0]], fx1, fy0);
-    nx1 = grad2(perm[ix1 + perm[iy1]], fx1, fy1);
-    n1 = LERP(t, nx0, nx1);
-
-    return 0.507f * ( LERP( s, n0, n1 ) );
-}
-
-//---------------------------------------------------------------------
-/** 2D float Perlin periodic noise.
- */
-float pnoise2( float x, float y, int px, int py )
-{
-    int ix0, iy0, ix1, iy1;
-    float fx0, fy0, fx1, fy1;
-    float s, t, nx0, nx1, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    iy0 = FASTFLOOR( y ); // Integer part of y
-    fx0 = x - ix0;        // Fractional part of x
-    fy0 = y - iy0;        // Fractional part of y
-    fx1 = fx0 - 1.0f;
-    fy1 = fy0 - 1.0f;
-    ix1 = (( ix0 + 1 ) % px) & 0xff;  // Wrap to 0..px-1 and wrap to 0..255
-    iy1 = (( iy0 + 1 ) % py) & 0xff;  // Wrap to 0..py-1 and wrap to 0..255
-    ix0 = ( ix0 % px ) & 0xff;
-    iy0 = ( iy0 % py ) & 0xff;
-    
-    t = FADE( fy0 );
-    s = FADE( fx0 );
-
-    nx0 = grad2(perm[ix0 + perm[iy0]], fx0, fy0);
-    nx1 = grad2(perm[ix0 + perm[iy1]], fx0, fy1);
-    n0 = LERP( t, nx0, nx1 );
-
-    nx0 = grad2(perm[ix1 + perm[iy0]], fx1, fy0);
-    nx1 = grad2(perm[ix1 + perm[iy1]], fx1, fy1);
-    n1 = LERP(t, nx0, nx1);
-
-    return 0.507f * ( LERP( s, n0, n1 ) );
-}
-
-
-//---------------------------------------------------------------------
-/** 3D float Perlin noise.
- */
-float noise3( float x, float y, float z )
-{
-    int ix0, iy0, ix1, iy1, iz0, iz1;
-    float fx0, fy0, fz0, fx1, fy1, fz1;
-    float s, t, r;
-    float nxy0, nxy1, nx0, nx1, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    iy0 = FASTFLOOR( y ); // Integer part of y
-    iz0 = FASTFLOOR( z ); // Integer part of z
-    fx0 = x - ix0;        // Fractional part of x
-    fy0 = y - iy0;        // Fractional part of y
-    fz0 = z - iz0;        // Fractional part of z
-    fx1 = fx0 - 1.0f;
-    fy1 = fy0 - 1.0f;
-    fz1 = fz0 - 1.0f;
-    ix1 = ( ix0 + 1 ) & 0xff; // Wrap to 0..255
-    iy1 = ( iy0 + 1 ) & 0xff;
-    iz1 = ( iz0 + 1 ) & 0xff;
-    ix0 = ix0 & 0xff;
-    iy0 = iy0 & 0xff;
-    iz0 = iz0 & 0xff;
-    
-    r = FADE( fz0 );
-    t = FADE( fy0 );
-    s = FADE( fx0 );
-
-    nxy0 = grad3(perm[ix0 + perm[iy0 + perm[iz0]]], fx0, fy0, fz0);
-    nxy1 = grad3(perm[ix0 + perm[iy0 + perm[iz1]]], fx0, fy0, fz1);
-    nx0 = LERP( r, nxy0, nxy1 );
-
-    nxy0 = grad3(perm[ix0 + perm[iy1 + perm[iz0]]], fx0, fy1, fz0);
-    nxy1 = grad3(perm[ix0 + perm[iy1 + perm[iz1]]], fx0, fy1, fz1);
-    nx1 = LERP( r, nxy0, nxy1 );
-
-    n0 = LERP( t, nx0, nx1 );
-
-    nxy0 = grad3(perm[ix1 + perm[iy0 + perm[iz0]]], fx1, fy0, fz0);
-    nxy1 = grad3(perm[ix1 + perm[iy0 + perm[iz1]]], fx1, fy0, fz1);
-    nx0 = LERP( r, nxy0, nxy1 );
-
-    nxy0 = grad3(perm[ix1 + perm[iy1 + perm[iz0]]], fx1, fy1, fz0);
-    nxy1 = grad3(perm[ix1 + perm[iy1 + perm[iz1]]], fx1, fy1, fz1);
-    nx1 = LERP( r, nxy0, nxy1 );
-
-    n1 = LERP( t, nx0, nx1 );
-    
-    return 0.936f * ( LERP( s, n0, n1 ) );
-}
-
-//---------------------------------------------------------------------
-/** 3D float Perlin periodic noise.
- */
-float pnoise3( float x, float y, float z, int px, int py, int pz )
-{
-    int ix0, iy0, ix1, iy1, iz0, iz1;
-    float fx0, fy0, fz0, fx1, fy1, fz1;
-    float s, t, r;
-    float nxy0, nxy1, nx0, nx1, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    iy0 = FASTFLOOR( y ); // Integer part of y
-    iz0 = FASTFLOOR( z ); // Integer part of z
-    fx0 = x - ix0;        // Fractional part of x
-    fy0 = y - iy0;        // Fractional part of y
-    fz0 = z - iz0;        // Fractional part of z
-    fx1 = fx0 - 1.0f;
-    fy1 = fy0 - 1.0f;
-    fz1 = fz0 - 1.0f;
-    ix1 = (( ix0 + 1 ) % px ) & 0xff; // Wrap to 0..px-1 and wrap to 0..255
-    iy1 = (( iy0 + 1 ) % py ) & 0xff; // Wrap to 0..py-1 and wrap to 0..255
-    iz1 = (( iz0 + 1 ) % pz ) & 0xff; // Wrap to 0..pz-1 and wrap to 0..255
-    ix0 = ( ix0 % px ) & 0xff;
-    iy0 = ( iy0 % py ) & 0xff;
-    iz0 = ( iz0 % pz ) & 0xff;
-    
-    r = FADE( fz0 );
-    t = FADE( fy0 );
-    s = FADE( fx0 );
-
-    nxy0 = grad3(perm[ix0 + perm[iy0 + perm[iz0]]], fx0, fy0, fz0);
-    nxy1 = grad3(perm[ix0 + perm[iy0 + perm[iz1]]], fx0, fy0, fz1);
-    nx0 = LERP( r, nxy0, nxy1 );
-
-    nxy0 = grad3(perm[ix0 + perm[iy1 + perm[iz0]]], fx0, fy1, fz0);
-    nxy1 = grad3(perm[ix0 + perm[iy1 + perm[iz1]]], fx0, fy1, fz1);
-    nx1 = LERP( r, nxy0, nxy1 );
-
-    n0 = LERP( t, nx0, nx1 );
-
-    nxy0 = grad3(perm[ix1 + perm[iy0 + perm[iz0]]], fx1, fy0, fz0);
-    nxy1 = grad3(perm[ix1 + perm[iy0 + perm[iz1]]], fx1, fy0, fz1);
-    nx0 = LERP( r, nxy0, nxy1 );
-
-    nxy0 = grad3(perm[ix1 + perm[iy1 + perm[iz0]]], fx1, fy1, fz0);
-    nxy1 = grad3(perm[ix1 + perm[iy1 + perm[iz1]]], fx1, fy1, fz1);
-    nx1 = LERP( r, nxy0, nxy1 );
-
-    n1 = LERP( t, nx0, nx1 );
-    
-    return 0.936f * ( LERP( s, n0, n1 ) );
-}
-
-
-//---------------------------------------------------------------------
-/** 4D float Perlin noise.
- */
-
-float noise4( float x, float y, float z, float w )
-{
-    int ix0, iy0, iz0, iw0, ix1, iy1, iz1, iw1;
-    float fx0, fy0, fz0, fw0, fx1, fy1, fz1, fw1;
-    float s, t, r, q;
-    float nxyz0, nxyz1, nxy0, nxy1, nx0, nx1, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    iy0 = FASTFLOOR( y ); // Integer part of y
-    iz0 = FASTFLOOR( z ); // Integer part of y
-    iw0 = FASTFLOOR( w ); // Integer part of w
-    fx0 = x - ix0;        // Fractional part of x
-    fy0 = y - iy0;        // Fractional part of y
-    fz0 = z - iz0;        // Fractional part of z
-    fw0 = w - iw0;        // Fractional part of w
-    fx1 = fx0 - 1.0f;
-    fy1 = fy0 - 1.0f;
-    fz1 = fz0 - 1.0f;
-    fw1 = fw0 - 1.0f;
-    ix1 = ( ix0 + 1 ) & 0xff;  // Wrap to 0..255
-    iy1 = ( iy0 + 1 ) & 0xff;
-    iz1 = ( iz0 + 1 ) & 0xff;
-    iw1 = ( iw0 + 1 ) & 0xff;
-    ix0 = ix0 & 0xff;
-    iy0 = iy0 & 0xff;
-    iz0 = iz0 & 0xff;
-    iw0 = iw0 & 0xff;
-
-    q = FADE( fw0 );
-    r = FADE( fz0 );
-    t = FADE( fy0 );
-    s = FADE( fx0 );
-
-    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx0, fy0, fz0, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx0, fy0, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx0, fy0, fz1, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx0, fy0, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-        
-    nx0 = LERP ( r, nxy0, nxy1 );
-
-    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx0, fy1, fz0, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx0, fy1, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx0, fy1, fz1, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx0, fy1, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-
-    nx1 = LERP ( r, nxy0, nxy1 );
-
-    n0 = LERP( t, nx0, nx1 );
-
-    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx1, fy0, fz0, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx1, fy0, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx1, fy0, fz1, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx1, fy0, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-
-    nx0 = LERP ( r, nxy0, nxy1 );
-
-    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx1, fy1, fz0, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx1, fy1, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx1, fy1, fz1, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx1, fy1, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-
-    nx1 = LERP ( r, nxy0, nxy1 );
-
-    n1 = LERP( t, nx0, nx1 );
-
-    return 0.87f * ( LERP( s, n0, n1 ) );
-}
-
-//---------------------------------------------------------------------
-/** 4D float Perlin periodic noise.
- */
-
-float pnoise4( float x, float y, float z, float w,
-                            int px, int py, int pz, int pw )
-{
-    int ix0, iy0, iz0, iw0, ix1, iy1, iz1, iw1;
-    float fx0, fy0, fz0, fw0, fx1, fy1, fz1, fw1;
-    float s, t, r, q;
-    float nxyz0, nxyz1, nxy0, nxy1, nx0, nx1, n0, n1;
-
-    ix0 = FASTFLOOR( x ); // Integer part of x
-    iy0 = FASTFLOOR( y ); // Integer part of y
-    iz0 = FASTFLOOR( z ); // Integer part of y
-    iw0 = FASTFLOOR( w ); // Integer part of w
-    fx0 = x - ix0;        // Fractional part of x
-    fy0 = y - iy0;        // Fractional part of y
-    fz0 = z - iz0;        // Fractional part of z
-    fw0 = w - iw0;        // Fractional part of w
-    fx1 = fx0 - 1.0f;
-    fy1 = fy0 - 1.0f;
-    fz1 = fz0 - 1.0f;
-    fw1 = fw0 - 1.0f;
-    ix1 = (( ix0 + 1 ) % px ) & 0xff;  // Wrap to 0..px-1 and wrap to 0..255
-    iy1 = (( iy0 + 1 ) % py ) & 0xff;  // Wrap to 0..py-1 and wrap to 0..255
-    iz1 = (( iz0 + 1 ) % pz ) & 0xff;  // Wrap to 0..pz-1 and wrap to 0..255
-    iw1 = (( iw0 + 1 ) % pw ) & 0xff;  // Wrap to 0..pw-1 and wrap to 0..255
-    ix0 = ( ix0 % px ) & 0xff;
-    iy0 = ( iy0 % py ) & 0xff;
-    iz0 = ( iz0 % pz ) & 0xff;
-    iw0 = ( iw0 % pw ) & 0xff;
-
-    q = FADE( fw0 );
-    r = FADE( fz0 );
-    t = FADE( fy0 );
-    s = FADE( fx0 );
-
-    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx0, fy0, fz0, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx0, fy0, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx0, fy0, fz1, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx0, fy0, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-        
-    nx0 = LERP ( r, nxy0, nxy1 );
-
-    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx0, fy1, fz0, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx0, fy1, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx0, fy1, fz1, fw0);
-    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx0, fy1, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-
-    nx1 = LERP ( r, nxy0, nxy1 );
-
-    n0 = LERP( t, nx0, nx1 );
-
-    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx1, fy0, fz0, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx1, fy0, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx1, fy0, fz1, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx1, fy0, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-
-    nx0 = LERP ( r, nxy0, nxy1 );
-
-    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx1, fy1, fz0, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx1, fy1, fz0, fw1);
-    nxy0 = LERP( q, nxyz0, nxyz1 );
-        
-    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx1, fy1, fz1, fw0);
-    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx1, fy1, fz1, fw1);
-    nxy1 = LERP( q, nxyz0, nxyz1 );
-
-    nx1 = LERP ( r, nxy0, nxy1 );
-
-    n1 = LERP( t, nx0, nx1 );
-
-    return 0.87f * ( LERP( s, n0, n1 ) );
+// noise1234
+//
+// Author: Stefan Gustavson, 2003-2005
+// Contact: stefan.gustavson@liu.se
+//
+// This code was GPL licensed until February 2011.
+// As the original author of this code, I hereby
+// release it into the public domain.
+// Please feel free to use it for whatever you want.
+// Credit is appreciated where appropriate, and I also
+// appreciate being told where this code finds any use,
+// but you may do as you like.
+
+/*
+ * This implementation is "Improved Noise" as presented by
+ * Ken Perlin at Siggraph 2002. The 3D function is a direct port
+ * of his Java reference code which was once publicly available
+ * on www.noisemachine.com (although I cleaned it up, made it
+ * faster and made the code more readable), but the 1D, 2D and
+ * 4D functions were implemented from scratch by me.
+ *
+ * This is a backport to C of my improved noise class in C++
+ * which was included in the Aqsis renderer project.
+ * It is highly reusable without source code modifications.
+ *
+ */
+
+#include "noise1234.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// This is the new and improved, C(2) continuous interpolant
+#define FADE(t) ( t * t * t * ( t * ( t * 6 - 15 ) + 10 ) )
+
+#define FASTFLOOR(x) ( ((int)(x)<(x)) ? ((int)x) : ((int)x-1 ) )
+#define LERP(t, a, b) ((a) + (t)*((b)-(a)))
+
+
+//---------------------------------------------------------------------
+// Static data
+
+/*
+ * Permutation table. This is just a random jumble of all numbers 0-255,
+ * repeated twice to avoid wrapping the index at 255 for each lookup.
+ * This needs to be exactly the same for all instances on all platforms,
+ * so it's easiest to just keep it as static explicit data.
+ * This also removes the need for any initialisation of this class.
+ *
+ * Note that making this an int[] instead of a char[] might make the
+ * code run faster on platforms with a high penalty for unaligned single
+ * byte addressing. Intel x86 is generally single-byte-friendly, but
+ * some other CPUs are faster with 4-aligned reads.
+ * However, a char[] is smaller, which avoids cache trashing, and that
+ * is probably the most important aspect on most architectures.
+ * This array is accessed a *lot* by the noise functions.
+ * A vector-valued noise over 3D accesses it 96 times, and a
+ * float-valued 4D noise 64 times. We want this to fit in the cache!
+ * It's padded with 3 bytes so 4 byte gathers from any index stay in bounds.
+ */
+unsigned char perm[512 + 3] = {151,160,137,91,90,15,
+  131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
+  190, 6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,
+  88,237,149,56,87,174,20,125,136,171,168, 68,175,74,165,71,134,139,48,27,166,
+  77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,55,46,245,40,244,
+  102,143,54, 65,25,63,161, 1,216,80,73,209,76,132,187,208, 89,18,169,200,196,
+  135,130,116,188,159,86,164,100,109,198,173,186, 3,64,52,217,226,250,124,123,
+  5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,
+  223,183,170,213,119,248,152, 2,44,154,163, 70,221,153,101,155,167, 43,172,9,
+  129,22,39,253, 19,98,108,110,79,113,224,232,178,185, 112,104,218,246,97,228,
+  251,34,242,193,238,210,144,12,191,179,162,241, 81,51,145,235,249,14,239,107,
+  49,192,214, 31,181,199,106,157,184, 84,204,176,115,121,50,45,127, 4,150,254,
+  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180,
+  151,160,137,91,90,15,
+  131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,8,99,37,240,21,10,23,
+  190, 6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,35,11,32,57,177,33,
+  88,237,149,56,87,174,20,125,136,171,168, 68,175,74,165,71,134,139,48,27,166,
+  77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,55,46,245,40,244,
+  102,143,54, 65,25,63,161, 1,216,80,73,209,76,132,187,208, 89,18,169,200,196,
+  135,130,116,188,159,86,164,100,109,198,173,186, 3,64,52,217,226,250,124,123,
+  5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,189,28,42,
+  223,183,170,213,119,248,152, 2,44,154,163, 70,221,153,101,155,167, 43,172,9,
+  129,22,39,253, 19,98,108,110,79,113,224,232,178,185, 112,104,218,246,97,228,
+  251,34,242,193,238,210,144,12,191,179,162,241, 81,51,145,235,249,14,239,107,
+  49,192,214, 31,181,199,106,157,184, 84,204,176,115,121,50,45,127, 4,150,254,
+  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180
+};
+
+//---------------------------------------------------------------------
+
+/*
+ * Helper functions to compute gradients-dot-residualvectors (1D to 4D)
+ * Note that these generate gradients of more than unit length. To make
+ * a close match with the value range of classic Perlin noise, the final
+ * noise values need to be rescaled. To match the RenderMan noise in a
+ * statistical sense, the approximate scaling values (empirically
+ * determined from test renderings) are:
+ * 1D noise needs rescaling with 0.188
+ * 2D noise needs rescaling with 0.507
+ * 3D noise needs rescaling with 0.936
+ * 4D noise needs rescaling with 0.87
+ * Note that these noise functions are the most practical and useful
+ * signed version of Perlin noise. To return values according to the
+ * RenderMan specification from the SL noise() and pnoise() functions,
+ * the noise values need to be scaled and offset to [0,1], like this:
+ * float SLnoise = (noise3(x,y,z) + 1.0) * 0.5;
+ */
+
+static float grad1( int hash, float x ) {
+    int h = hash & 15;
+    float grad = 1.0 + (h & 7);  // Gradient value 1.0, 2.0, ..., 8.0
+    if (h&8) grad = -grad;         // and a random sign for the gradient
+    return ( grad * x );           // Multiply the gradient with the distance
+}
+
+static float grad2( int hash, float x, float y ) {
+    int h = hash & 7;      // Convert low 3 bits of hash code
+    float u = h<4 ? x : y;  // into 8 simple gradient directions,
+    float v = h<4 ? y : x;  // and compute the dot product with (x,y).
+    return ((h&1)? -u : u) + ((h&2)? -2.0*v : 2.0*v);
+}
+
+static float grad3( int hash, float x, float y , float z ) {
+    int h = hash & 15;     // Convert low 4 bits of hash code into 12 simple
+    float u = h<8 ? x : y; // gradient directions, and compute dot product.
+    float v = h<4 ? y : h==12||h==14 ? x : z; // Fix repeats at h = 12 to 15
+    return ((h&1)? -u : u) + ((h&2)? -v : v);
+}
+
+static float grad4( int hash, float x, float y, float z, float t ) {
+    int h = hash & 31;      // Convert low 5 bits of hash code into 32 simple
+    float u = h<24 ? x : y; // gradient directions, and compute dot product.
+    float v = h<16 ? y : z;
+    float w = h<8 ? z : t;
+    return ((h&1)? -u : u) + ((h&2)? -v : v) + ((h&4)? -w : w);
+}
+
+//---------------------------------------------------------------------
+/** 1D float Perlin noise, SL "noise()"
+ */
+float noise1( float x )
+{
+    int ix0, ix1;
+    float fx0, fx1;
+    float s, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    fx0 = x - ix0;       // Fractional part of x
+    fx1 = fx0 - 1.0f;
+    ix1 = ( ix0+1 ) & 0xff;
+    ix0 = ix0 & 0xff;    // Wrap to 0..255
+
+    s = FADE( fx0 );
+
+    n0 = grad1( perm[ ix0 ], fx0 );
+    n1 = grad1( perm[ ix1 ], fx1 );
+    return 0.188f * ( LERP( s, n0, n1 ) );
+}
+
+//---------------------------------------------------------------------
+/** 1D float Perlin periodic noise, SL "pnoise()"
+ */
+float pnoise1( float x, int px )
+{
+    int ix0, ix1;
+    float fx0, fx1;
+    float s, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    fx0 = x - ix0;       // Fractional part of x
+    fx1 = fx0 - 1.0f;
+    ix1 = (( ix0 + 1 ) % px) & 0xff; // Wrap to 0..px-1 *and* wrap to 0..255
+    ix0 = ( ix0 % px ) & 0xff;      // (because px might be greater than 256)
+
+    s = FADE( fx0 );
+
+    n0 = grad1( perm[ ix0 ], fx0 );
+    n1 = grad1( perm[ ix1 ], fx1 );
+    return 0.188f * ( LERP( s, n0, n1 ) );
+}
+
+
+//---------------------------------------------------------------------
+/** 2D float Perlin noise.
+ */
+float noise2( float x, float y )
+{
+    int ix0, iy0, ix1, iy1;
+    float fx0, fy0, fx1, fy1;
+    float s, t, nx0, nx1, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    iy0 = FASTFLOOR( y ); // Integer part of y
+    fx0 = x - ix0;        // Fractional part of x
+    fy0 = y - iy0;        // Fractional part of y
+    fx1 = fx0 - 1.0f;
+    fy1 = fy0 - 1.0f;
+    ix1 = (ix0 + 1) & 0xff;  // Wrap to 0..255
+    iy1 = (iy0 + 1) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    
+    t = FADE( fy0 );
+    s = FADE( fx0 );
+
+    nx0 = grad2(perm[ix0 + perm[iy0]], fx0, fy0);
+    nx1 = grad2(perm[ix0 + perm[iy1]], fx0, fy1);
+    n0 = LERP( t, nx0, nx1 );
+
+    nx0 = grad2(perm[ix1 + perm[iy0]], fx1, fy0);
+    nx1 = grad2(perm[ix1 + perm[iy1]], fx1, fy1);
+    n1 = LERP(t, nx0, nx1);
+
+    return 0.507f * ( LERP( s, n0, n1 ) );
+}
+
+//---------------------------------------------------------------------
+/** 2D float Perlin periodic noise.
+ */
+float pnoise2( float x, float y, int px, int py )
+{
+    int ix0, iy0, ix1, iy1;
+    float fx0, fy0, fx1, fy1;
+    float s, t, nx0, nx1, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    iy0 = FASTFLOOR( y ); // Integer part of y
+    fx0 = x - ix0;        // Fractional part of x
+    fy0 = y - iy0;        // Fractional part of y
+    fx1 = fx0 - 1.0f;
+    fy1 = fy0 - 1.0f;
+    ix1 = (( ix0 + 1 ) % px) & 0xff;  // Wrap to 0..px-1 and wrap to 0..255
+    iy1 = (( iy0 + 1 ) % py) & 0xff;  // Wrap to 0..py-1 and wrap to 0..255
+    ix0 = ( ix0 % px ) & 0xff;
+    iy0 = ( iy0 % py ) & 0xff;
+    
+    t = FADE( fy0 );
+    s = FADE( fx0 );
+
+    nx0 = grad2(perm[ix0 + perm[iy0]], fx0, fy0);
+    nx1 = grad2(perm[ix0 + perm[iy1]], fx0, fy1);
+    n0 = LERP( t, nx0, nx1 );
+
+    nx0 = grad2(perm[ix1 + perm[iy0]], fx1, fy0);
+    nx1 = grad2(perm[ix1 + perm[iy1]], fx1, fy1);
+    n1 = LERP(t, nx0, nx1);
+
+    return 0.507f * ( LERP( s, n0, n1 ) );
+}
+
+
+//---------------------------------------------------------------------
+/** 3D float Perlin noise.
+ */
+float noise3( float x, float y, float z )
+{
+    int ix0, iy0, ix1, iy1, iz0, iz1;
+    float fx0, fy0, fz0, fx1, fy1, fz1;
+    float s, t, r;
+    float nxy0, nxy1, nx0, nx1, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    iy0 = FASTFLOOR( y ); // Integer part of y
+    iz0 = FASTFLOOR( z ); // Integer part of z
+    fx0 = x - ix0;        // Fractional part of x
+    fy0 = y - iy0;        // Fractional part of y
+    fz0 = z - iz0;        // Fractional part of z
+    fx1 = fx0 - 1.0f;
+    fy1 = fy0 - 1.0f;
+    fz1 = fz0 - 1.0f;
+    ix1 = ( ix0 + 1 ) & 0xff; // Wrap to 0..255
+    iy1 = ( iy0 + 1 ) & 0xff;
+    iz1 = ( iz0 + 1 ) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    iz0 = iz0 & 0xff;
+    
+    r = FADE( fz0 );
+    t = FADE( fy0 );
+    s = FADE( fx0 );
+
+    nxy0 = grad3(perm[ix0 + perm[iy0 + perm[iz0]]], fx0, fy0, fz0);
+    nxy1 = grad3(perm[ix0 + perm[iy0 + perm[iz1]]], fx0, fy0, fz1);
+    nx0 = LERP( r, nxy0, nxy1 );
+
+    nxy0 = grad3(perm[ix0 + perm[iy1 + perm[iz0]]], fx0, fy1, fz0);
+    nxy1 = grad3(perm[ix0 + perm[iy1 + perm[iz1]]], fx0, fy1, fz1);
+    nx1 = LERP( r, nxy0, nxy1 );
+
+    n0 = LERP( t, nx0, nx1 );
+
+    nxy0 = grad3(perm[ix1 + perm[iy0 + perm[iz0]]], fx1, fy0, fz0);
+    nxy1 = grad3(perm[ix1 + perm[iy0 + perm[iz1]]], fx1, fy0, fz1);
+    nx0 = LERP( r, nxy0, nxy1 );
+
+    nxy0 = grad3(perm[ix1 + perm[iy1 + perm[iz0]]], fx1, fy1, fz0);
+    nxy1 = grad3(perm[ix1 + perm[iy1 + perm[iz1]]], fx1, fy1, fz1);
+    nx1 = LERP( r, nxy0, nxy1 );
+
+    n1 = LERP( t, nx0, nx1 );
+    
+    return 0.936f * ( LERP( s, n0, n1 ) );
+}
+
+//---------------------------------------------------------------------
+/** 3D float Perlin periodic noise.
+ */
+float pnoise3( float x, float y, float z, int px, int py, int pz )
+{
+    int ix0, iy0, ix1, iy1, iz0, iz1;
+    float fx0, fy0, fz0, fx1, fy1, fz1;
+    float s, t, r;
+    float nxy0, nxy1, nx0, nx1, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    iy0 = FASTFLOOR( y ); // Integer part of y
+    iz0 = FASTFLOOR( z ); // Integer part of z
+    fx0 = x - ix0;        // Fractional part of x
+    fy0 = y - iy0;        // Fractional part of y
+    fz0 = z - iz0;        // Fractional part of z
+    fx1 = fx0 - 1.0f;
+    fy1 = fy0 - 1.0f;
+    fz1 = fz0 - 1.0f;
+    ix1 = (( ix0 + 1 ) % px ) & 0xff; // Wrap to 0..px-1 and wrap to 0..255
+    iy1 = (( iy0 + 1 ) % py ) & 0xff; // Wrap to 0..py-1 and wrap to 0..255
+    iz1 = (( iz0 + 1 ) % pz ) & 0xff; // Wrap to 0..pz-1 and wrap to 0..255
+    ix0 = ( ix0 % px ) & 0xff;
+    iy0 = ( iy0 % py ) & 0xff;
+    iz0 = ( iz0 % pz ) & 0xff;
+    
+    r = FADE( fz0 );
+    t = FADE( fy0 );
+    s = FADE( fx0 );
+
+    nxy0 = grad3(perm[ix0 + perm[iy0 + perm[iz0]]], fx0, fy0, fz0);
+    nxy1 = grad3(perm[ix0 + perm[iy0 + perm[iz1]]], fx0, fy0, fz1);
+    nx0 = LERP( r, nxy0, nxy1 );
+
+    nxy0 = grad3(perm[ix0 + perm[iy1 + perm[iz0]]], fx0, fy1, fz0);
+    nxy1 = grad3(perm[ix0 + perm[iy1 + perm[iz1]]], fx0, fy1, fz1);
+    nx1 = LERP( r, nxy0, nxy1 );
+
+    n0 = LERP( t, nx0, nx1 );
+
+    nxy0 = grad3(perm[ix1 + perm[iy0 + perm[iz0]]], fx1, fy0, fz0);
+    nxy1 = grad3(perm[ix1 + perm[iy0 + perm[iz1]]], fx1, fy0, fz1);
+    nx0 = LERP( r, nxy0, nxy1 );
+
+    nxy0 = grad3(perm[ix1 + perm[iy1 + perm[iz0]]], fx1, fy1, fz0);
+    nxy1 = grad3(perm[ix1 + perm[iy1 + perm[iz1]]], fx1, fy1, fz1);
+    nx1 = LERP( r, nxy0, nxy1 );
+
+    n1 = LERP( t, nx0, nx1 );
+    
+    return 0.936f * ( LERP( s, n0, n1 ) );
+}
+
+
+//---------------------------------------------------------------------
+/** 4D float Perlin noise.
+ */
+
+float noise4( float x, float y, float z, float w )
+{
+    int ix0, iy0, iz0, iw0, ix1, iy1, iz1, iw1;
+    float fx0, fy0, fz0, fw0, fx1, fy1, fz1, fw1;
+    float s, t, r, q;
+    float nxyz0, nxyz1, nxy0, nxy1, nx0, nx1, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    iy0 = FASTFLOOR( y ); // Integer part of y
+    iz0 = FASTFLOOR( z ); // Integer part of y
+    iw0 = FASTFLOOR( w ); // Integer part of w
+    fx0 = x - ix0;        // Fractional part of x
+    fy0 = y - iy0;        // Fractional part of y
+    fz0 = z - iz0;        // Fractional part of z
+    fw0 = w - iw0;        // Fractional part of w
+    fx1 = fx0 - 1.0f;
+    fy1 = fy0 - 1.0f;
+    fz1 = fz0 - 1.0f;
+    fw1 = fw0 - 1.0f;
+    ix1 = ( ix0 + 1 ) & 0xff;  // Wrap to 0..255
+    iy1 = ( iy0 + 1 ) & 0xff;
+    iz1 = ( iz0 + 1 ) & 0xff;
+    iw1 = ( iw0 + 1 ) & 0xff;
+    ix0 = ix0 & 0xff;
+    iy0 = iy0 & 0xff;
+    iz0 = iz0 & 0xff;
+    iw0 = iw0 & 0xff;
+
+    q = FADE( fw0 );
+    r = FADE( fz0 );
+    t = FADE( fy0 );
+    s = FADE( fx0 );
+
+    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx0, fy0, fz0, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx0, fy0, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx0, fy0, fz1, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx0, fy0, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+        
+    nx0 = LERP ( r, nxy0, nxy1 );
+
+    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx0, fy1, fz0, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx0, fy1, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx0, fy1, fz1, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx0, fy1, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+
+    nx1 = LERP ( r, nxy0, nxy1 );
+
+    n0 = LERP( t, nx0, nx1 );
+
+    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx1, fy0, fz0, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx1, fy0, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx1, fy0, fz1, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx1, fy0, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+
+    nx0 = LERP ( r, nxy0, nxy1 );
+
+    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx1, fy1, fz0, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx1, fy1, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx1, fy1, fz1, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx1, fy1, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+
+    nx1 = LERP ( r, nxy0, nxy1 );
+
+    n1 = LERP( t, nx0, nx1 );
+
+    return 0.87f * ( LERP( s, n0, n1 ) );
+}
+
+//---------------------------------------------------------------------
+/** 4D float Perlin periodic noise.
+ */
+
+float pnoise4( float x, float y, float z, float w,
+                            int px, int py, int pz, int pw )
+{
+    int ix0, iy0, iz0, iw0, ix1, iy1, iz1, iw1;
+    float fx0, fy0, fz0, fw0, fx1, fy1, fz1, fw1;
+    float s, t, r, q;
+    float nxyz0, nxyz1, nxy0, nxy1, nx0, nx1, n0, n1;
+
+    ix0 = FASTFLOOR( x ); // Integer part of x
+    iy0 = FASTFLOOR( y ); // Integer part of y
+    iz0 = FASTFLOOR( z ); // Integer part of y
+    iw0 = FASTFLOOR( w ); // Integer part of w
+    fx0 = x - ix0;        // Fractional part of x
+    fy0 = y - iy0;        // Fractional part of y
+    fz0 = z - iz0;        // Fractional part of z
+    fw0 = w - iw0;        // Fractional part of w
+    fx1 = fx0 - 1.0f;
+    fy1 = fy0 - 1.0f;
+    fz1 = fz0 - 1.0f;
+    fw1 = fw0 - 1.0f;
+    ix1 = (( ix0 + 1 ) % px ) & 0xff;  // Wrap to 0..px-1 and wrap to 0..255
+    iy1 = (( iy0 + 1 ) % py ) & 0xff;  // Wrap to 0..py-1 and wrap to 0..255
+    iz1 = (( iz0 + 1 ) % pz ) & 0xff;  // Wrap to 0..pz-1 and wrap to 0..255
+    iw1 = (( iw0 + 1 ) % pw ) & 0xff;  // Wrap to 0..pw-1 and wrap to 0..255
+    ix0 = ( ix0 % px ) & 0xff;
+    iy0 = ( iy0 % py ) & 0xff;
+    iz0 = ( iz0 % pz ) & 0xff;
+    iw0 = ( iw0 % pw ) & 0xff;
+
+    q = FADE( fw0 );
+    r = FADE( fz0 );
+    t = FADE( fy0 );
+    s = FADE( fx0 );
+
+    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx0, fy0, fz0, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx0, fy0, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx0, fy0, fz1, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx0, fy0, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+        
+    nx0 = LERP ( r, nxy0, nxy1 );
+
+    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx0, fy1, fz0, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx0, fy1, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx0, fy1, fz1, fw0);
+    nxyz1 = grad4(perm[ix0 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx0, fy1, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+
+    nx1 = LERP ( r, nxy0, nxy1 );
+
+    n0 = LERP( t, nx0, nx1 );
+
+    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw0]]]], fx1, fy0, fz0, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz0 + perm[iw1]]]], fx1, fy0, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw0]]]], fx1, fy0, fz1, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy0 + perm[iz1 + perm[iw1]]]], fx1, fy0, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+
+    nx0 = LERP ( r, nxy0, nxy1 );
+
+    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw0]]]], fx1, fy1, fz0, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz0 + perm[iw1]]]], fx1, fy1, fz0, fw1);
+    nxy0 = LERP( q, nxyz0, nxyz1 );
+        
+    nxyz0 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw0]]]], fx1, fy1, fz1, fw0);
+    nxyz1 = grad4(perm[ix1 + perm[iy1 + perm[iz1 + perm[iw1]]]], fx1, fy1, fz1, fw1);
+    nxy1 = LERP( q, nxyz0, nxyz1 );
+
+    nx1 = LERP ( r, nxy0, nxy1 );
+
+    n1 = LERP( t, nx0, nx1 );
+
+    return 0.87f * ( LERP( s, n0, n1 ) );
+}
+
+//---------------------------------------------------------------------
+/*
+ * SIMD versions of the helpers above, doing the same operations in the same
+ * order so the batch gives exactly what noise2 does. The gradients' signs are
+ * flipped by moving bits 0 and 1 of the hash into the sign bit. 2*v is exact
+ * in float, so the sum is rounded once, as it is in double in grad2.
+ */
+#if defined(__AVX2__)
+static __m256i fastfloor8( __m256 x ) {
+    __m256i i = _mm256_cvttps_epi32( x );
+    // i - 1, unless (int)x < x which gives an all ones mask, i.e. -1
+    __m256i lt = _mm256_castps_si256( _mm256_cmp_ps( _mm256_cvtepi32_ps( i ), x, _CMP_LT_OQ ) );
+    return _mm256_sub_epi32( _mm256_sub_epi32( i, _mm256_set1_epi32( 1 ) ), lt );
+}
+
+static __m256 fade8( __m256 t ) {
+    __m256 ttt = _mm256_mul_ps( _mm256_mul_ps( t, t ), t );
+    __m256 inner = _mm256_sub_ps( _mm256_mul_ps( t, _mm256_set1_ps( 6 ) ), _mm256_set1_ps( 15 ) );
+    return _mm256_mul_ps( ttt, _mm256_add_ps( _mm256_mul_ps( t, inner ), _mm256_set1_ps( 10 ) ) );
+}
+
+static __m256 lerp8( __m256 t, __m256 a, __m256 b ) {
+    return _mm256_add_ps( a, _mm256_mul_ps( t, _mm256_sub_ps( b, a ) ) );
+}
+
+static __m256 grad2_8( __m256i hash, __m256 x, __m256 y ) {
+    __m256i h = _mm256_and_si256( hash, _mm256_set1_epi32( 7 ) );
+    __m256 lt4 = _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( h, _mm256_set1_epi32( 4 ) ), _mm256_setzero_si256() ) );
+    __m256 u = _mm256_blendv_ps( y, x, lt4 );
+    __m256 v = _mm256_blendv_ps( x, y, lt4 );
+    __m256 u_sign = _mm256_castsi256_ps( _mm256_slli_epi32( _mm256_and_si256( h, _mm256_set1_epi32( 1 ) ), 31 ) );
+    __m256 v_sign = _mm256_castsi256_ps( _mm256_slli_epi32( _mm256_and_si256( h, _mm256_set1_epi32( 2 ) ), 30 ) );
+    u = _mm256_xor_ps( u, u_sign );
+    v = _mm256_xor_ps( _mm256_mul_ps( v, _mm256_set1_ps( 2.0f ) ), v_sign );
+    return _mm256_add_ps( u, v );
+}
+
+// perm[i] of each lane, gathering the 4 bytes from i and keeping the first
+static __m256i perm8( __m256i i ) {
+    return _mm256_and_si256( _mm256_i32gather_epi32( (const int *)perm, i, 1 ), _mm256_set1_epi32( 0xff ) );
+}
+
+// 8 points at a time, returning how many were done
+static size_t noise2_batch8( const float *xs, const float *ys, float *out, size_t n )
+{
+    const __m256i wrap = _mm256_set1_epi32( 0xff );
+    size_t i = 0;
+    for ( ; i + 8 <= n; i += 8 ) {
+        __m256 x = _mm256_loadu_ps( xs + i );
+        __m256 y = _mm256_loadu_ps( ys + i );
+        __m256i ix0 = fastfloor8( x );
+        __m256i iy0 = fastfloor8( y );
+        __m256 fx0 = _mm256_sub_ps( x, _mm256_cvtepi32_ps( ix0 ) );
+        __m256 fy0 = _mm256_sub_ps( y, _mm256_cvtepi32_ps( iy0 ) );
+        __m256 fx1 = _mm256_sub_ps( fx0, _mm256_set1_ps( 1.0f ) );
+        __m256 fy1 = _mm256_sub_ps( fy0, _mm256_set1_ps( 1.0f ) );
+        __m256i ix1 = _mm256_and_si256( _mm256_add_epi32( ix0, _mm256_set1_epi32( 1 ) ), wrap );
+        __m256i iy1 = _mm256_and_si256( _mm256_add_epi32( iy0, _mm256_set1_epi32( 1 ) ), wrap );
+        ix0 = _mm256_and_si256( ix0, wrap );
+        iy0 = _mm256_and_si256( iy0, wrap );
+
+        __m256 t = fade8( fy0 );
+        __m256 s = fade8( fx0 );
+        __m256i py0 = perm8( iy0 );
+        __m256i py1 = perm8( iy1 );
+
+        __m256 nx0 = grad2_8( perm8( _mm256_add_epi32( ix0, py0 ) ), fx0, fy0 );
+        __m256 nx1 = grad2_8( perm8( _mm256_add_epi32( ix0, py1 ) ), fx0, fy1 );
+        __m256 n0 = lerp8( t, nx0, nx1 );
+
+        nx0 = grad2_8( perm8( _mm256_add_epi32( ix1, py0 ) ), fx1, fy0 );
+        nx1 = grad2_8( perm8( _mm256_add_epi32( ix1, py1 ) ), fx1, fy1 );
+        __m256 n1 = lerp8( t, nx0, nx1 );
+
+        _mm256_storeu_ps( out + i, _mm256_mul_ps( _mm256_set1_ps( 0.507f ), lerp8( s, n0, n1 ) ) );
+    }
+    return i;
+}
+
+#elif defined(__SSE2__)
+static __m128i fastfloor4( __m128 x ) {
+    __m128i i = _mm_cvttps_epi32( x );
+    // i - 1, unless (int)x < x which gives an all ones mask, i.e. -1
+    __m128i lt = _mm_castps_si128( _mm_cmplt_ps( _mm_cvtepi32_ps( i ), x ) );
+    return _mm_sub_epi32( _mm_sub_epi32( i, _mm_set1_epi32( 1 ) ), lt );
+}
+
+static __m128 fade4( __m128 t ) {
+    __m128 ttt = _mm_mul_ps( _mm_mul_ps( t, t ), t );
+    __m128 inner = _mm_sub_ps( _mm_mul_ps( t, _mm_set1_ps( 6 ) ), _mm_set1_ps( 15 ) );
+    return _mm_mul_ps( ttt, _mm_add_ps( _mm_mul_ps( t, inner ), _mm_set1_ps( 10 ) ) );
+}
+
+static __m128 lerp4( __m128 t, __m128 a, __m128 b ) {
+    return _mm_add_ps( a, _mm_mul_ps( t, _mm_sub_ps( b, a ) ) );
+}
+
+static __m128 grad2_4( __m128i hash, __m128 x, __m128 y ) {
+    __m128i h = _mm_and_si128( hash, _mm_set1_epi32( 7 ) );
+    __m128 lt4 = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( h, _mm_set1_epi32( 4 ) ), _mm_setzero_si128() ) );
+    __m128 u = _mm_or_ps( _mm_and_ps( lt4, x ), _mm_andnot_ps( lt4, y ) );
+    __m128 v = _mm_or_ps( _mm_and_ps( lt4, y ), _mm_andnot_ps( lt4, x ) );
+    __m128 u_sign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 1 ) ), 31 ) );
+    __m128 v_sign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 2 ) ), 30 ) );
+    u = _mm_xor_ps( u, u_sign );
+    v = _mm_xor_ps( _mm_mul_ps( v, _mm_set1_ps( 2.0f ) ), v_sign );
+    return _mm_add_ps( u, v );
+}
+
+// 4 points at a time, returning how many were done. SSE2 has no gathers, so the permutations are looked up per point
+static size_t noise2_batch4( const float *xs, const float *ys, float *out, size_t n )
+{
+    const __m128i wrap = _mm_set1_epi32( 0xff );
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4 ) {
+        __m128 x = _mm_loadu_ps( xs + i );
+        __m128 y = _mm_loadu_ps( ys + i );
+        __m128i ix0 = fastfloor4( x );
+        __m128i iy0 = fastfloor4( y );
+        __m128 fx0 = _mm_sub_ps( x, _mm_cvtepi32_ps( ix0 ) );
+        __m128 fy0 = _mm_sub_ps( y, _mm_cvtepi32_ps( iy0 ) );
+        __m128 fx1 = _mm_sub_ps( fx0, _mm_set1_ps( 1.0f ) );
+        __m128 fy1 = _mm_sub_ps( fy0, _mm_set1_ps( 1.0f ) );
+        __m128i ix1 = _mm_and_si128( _mm_add_epi32( ix0, _mm_set1_epi32( 1 ) ), wrap );
+        __m128i iy1 = _mm_and_si128( _mm_add_epi32( iy0, _mm_set1_epi32( 1 ) ), wrap );
+        ix0 = _mm_and_si128( ix0, wrap );
+        iy0 = _mm_and_si128( iy0, wrap );
+
+        __m128 t = fade4( fy0 );
+        __m128 s = fade4( fx0 );
+
+        int ix0s[4], iy0s[4], ix1s[4], iy1s[4];
+        _mm_storeu_si128( (__m128i *)ix0s, ix0 );
+        _mm_storeu_si128( (__m128i *)iy0s, iy0 );
+        _mm_storeu_si128( (__m128i *)ix1s, ix1 );
+        _mm_storeu_si128( (__m128i *)iy1s, iy1 );
+        // set from registers, loading a vector just stored a lane at a time stalls
+        #define HASH4( ixs, iys ) _mm_setr_epi32( perm[ixs[0] + perm[iys[0]]], perm[ixs[1] + perm[iys[1]]], \
+                                                  perm[ixs[2] + perm[iys[2]]], perm[ixs[3] + perm[iys[3]]] )
+        __m128 nx0 = grad2_4( HASH4( ix0s, iy0s ), fx0, fy0 );
+        __m128 nx1 = grad2_4( HASH4( ix0s, iy1s ), fx0, fy1 );
+        __m128 n0 = lerp4( t, nx0, nx1 );
+
+        nx0 = grad2_4( HASH4( ix1s, iy0s ), fx1, fy0 );
+        nx1 = grad2_4( HASH4( ix1s, iy1s ), fx1, fy1 );
+        #undef HASH4
+        __m128 n1 = lerp4( t, nx0, nx1 );
+
+        _mm_storeu_ps( out + i, _mm_mul_ps( _mm_set1_ps( 0.507f ), lerp4( s, n0, n1 ) ) );
+    }
+    return i;
+}
+#endif
+
+/** 2D float Perlin noise of n points, the rest after the last full batch done by noise2.
+ */
+void noise2_batch( const float *xs, const float *ys, float *out, size_t n )
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    i = noise2_batch8( xs, ys, out, n );
+#elif defined(__SSE2__)
+    i = noise2_batch4( xs, ys, out, n );
+#endif
+    for ( ; i < n; i++ ) {
+        out[i] = noise2( xs[i], ys[i] );
+    }
 }
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "profiler.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "util.h"
+#include "containers/list.h"
+
+LIST_DECLARE(float)
+LIST_DEFINE(float)
+
+#define GPU_ZONES_COUNT (PROFILE_ZONES_COUNT - PROFILE_ZONE_GPU_WORLD)
+// trace thread of the GPU passes, CPU threads are numbered from 1 as they first push an event
+#define GPU_THREAD      0
+
+/*
+ * A slot of the ring. The ring is a bounded multi producer queue: a producer claims the slot at head once its
+ * sequence equals head, and publishes it by setting sequence to head + 1, which is what the consumer waits for.
+ * Once read the consumer sets sequence a lap ahead to hand the slot back.
+ */
+typedef struct profile_event {
+    atomic_size_t sequence;
+    profile_zone  zone;
+    uint32_t      thread;
+    double        start;
+    double        duration;
+} profile_event;
+
+typedef struct gpu_query {
+    GLuint query;
+    bool   pending;
+    // CPU time the pass was issued at
+    double issued;
+} gpu_query;
+
+static const char *const zone_names[PROFILE_ZONES_COUNT] = {
+    [PROFILE_ZONE_FRAME]        = "frame",
+    [PROFILE_ZONE_INPUT]        = "input",
+    [PROFILE_ZONE_STREAM]       = "stream",
+    [PROFILE_ZONE_UPDATE]       = "update",
+    [PROFILE_ZONE_UPLOAD]       = "upload",
+    [PROFILE_ZONE_WORLD_RENDER] = "world_render",
+    [PROFILE_ZONE_MODEL_RENDER] = "model_render",
+    [PROFILE_ZONE_RAY_CAST]     = "ray_cast",
+    [PROFILE_ZONE_MESH]         = "mesh",
+    [PROFILE_ZONE_GENERATE]     = "generate",
+    [PROFILE_ZONE_GPU_WORLD]    = "gpu_world",
+    [PROFILE_ZONE_GPU_MODEL]    = "gpu_model",
+    [PROFILE_ZONE_GPU_SELECTOR] = "gpu_selector",
+};
+
+// one per process, like the GL context it times
+static struct {
+    // set before the workers are started and cleared after they're joined, so it's never written concurrently
+    bool          enabled;
+    double        epoch;
+    profile_event ring[PROFILER_RING_CAP];
+    atomic_size_t head;
+    // only touched by the consumer
+    size_t        tail;
+    atomic_size_t dropped;
+    // GPU results that weren't ready when their query was due
+    size_t        gpu_dropped;
+    atomic_uint   threads;
+    // durations of every event of each zone, in seconds
+    list_float    samples[PROFILE_ZONES_COUNT];
+    gpu_query     queries[PROFILER_GPU_LATENCY][GPU_ZONES_COUNT];
+    size_t        frame;
+    FILE          *trace;
+    size_t        trace_events;
+} profiler;
+
+static _Thread_local uint32_t thread_id;
+
+bool profiler_init(const char *trace_path)
+{
+    profiler.epoch = time_seconds();
+    for (size_t i = 0; i < PROFILER_RING_CAP; i++) {
+        atomic_init(&profiler.ring[i].sequence, i);
+    }
+    atomic_init(&profiler.head, 0);
+    profiler.tail = 0;
+    atomic_init(&profiler.dropped, 0);
+    profiler.gpu_dropped = 0;
+    atomic_init(&profiler.threads, 0);
+    for (int z = 0; z < PROFILE_ZONES_COUNT; z++) {
+        list_float_init(&profiler.samples[z]);
+    }
+    for (int f = 0; f < PROFILER_GPU_LATENCY; f++) {
+        for (int z = 0; z < GPU_ZONES_COUNT; z++) {
+            glGenQueries(1, &profiler.queries[f][z].query);
+            profiler.queries[f][z].pending = false;
+        }
+    }
+    profiler.frame = 0;
+    profiler.trace = NULL;
+    profiler.trace_events = 0;
+    profiler.enabled = true;
+    if (trace_path == NULL) return true;
+
+    profiler.trace = fopen(trace_path, "w");
+    if (profiler.trace == NULL) return false;
+    fprintf(profiler.trace, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(profiler.trace, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"gpu\"}}",
+            GPU_THREAD);
+    return true;
+}
+
+// drops the event if the ring is full
+static void profiler_push(profile_zone zone, double start, double duration)
+{
+    if (thread_id == 0) {
+        thread_id = atomic_fetch_add_explicit(&profiler.threads, 1, memory_order_relaxed) + 1;
+    }
+    size_t pos = atomic_load_explicit(&profiler.head, memory_order_relaxed);
+    profile_event *e;
+    for (;;) {
+        e = &profiler.ring[pos & (PROFILER_RING_CAP - 1)];
+        size_t sequence = atomic_load_explicit(&e->sequence, memory_order_acquire);
+        if (sequence == pos) {
+            // on failure pos is reloaded with the new head
+            if (atomic_compare_exchange_weak_explicit(&profiler.head, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) break;
+        } else if (sequence < pos) {
+            // the slot still holds an event from the last lap
+            atomic_fetch_add_explicit(&profiler.dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&profiler.head, memory_order_relaxed);
+        }
+    }
+    e->zone = zone;
+    e->thread = thread_id;
+    e->start = start;
+    e->duration = duration;
+    atomic_store_explicit(&e->sequence, pos + 1, memory_order_release);
+}
+
+double profiler_begin(void)
+{
+    return profiler.enabled ? time_seconds() : 0;
+}
+
+void profiler_end(profile_zone zone, double start)
+{
+    if (!profiler.enabled) return;
+    profiler_push(zone, start, time_seconds() - start);
+}
+
+void profiler_gpu_begin(profile_zone zone)
+{
+    if (!profiler.enabled) return;
+    gpu_query *q = &profiler.queries[profiler.frame % PROFILER_GPU_LATENCY][zone - PROFILE_ZONE_GPU_WORLD];
+    q->issued = time_seconds();
+    glBeginQuery(GL_TIME_ELAPSED, q->query);
+}
+
+void profiler_gpu_end(profile_zone zone)
+{
+    if (!profiler.enabled) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    profiler.queries[profiler.frame % PROFILER_GPU_LATENCY][zone - PROFILE_ZONE_GPU_WORLD].pending = true;
+}
+
+static void profiler_record(profile_zone zone, uint32_t thread, double start, double duration)
+{
+    *list_float_add(&profiler.samples[zone]) = duration;
+    if (profiler.trace == NULL) return;
+    // complete events, in microseconds since profiler_init
+    fprintf(profiler.trace, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+            zone_names[zone], thread, (start - profiler.epoch) * 1e6, duration * 1e6);
+    profiler.trace_events++;
+}
+
+void profiler_collect(void)
+{
+    if (!profiler.enabled) return;
+    // the next frame reuses the slots of the queries issued PROFILER_GPU_LATENCY - 1 frames ago, so they're due
+    profiler.frame++;
+    gpu_query *due = profiler.queries[profiler.frame % PROFILER_GPU_LATENCY];
+    for (int z = 0; z < GPU_ZONES_COUNT; z++) {
+        if (!due[z].pending) continue;
+        due[z].pending = false;
+        GLint available;
+        glGetQueryObjectiv(due[z].query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            profiler.gpu_dropped++;
+            continue;
+        }
+        GLuint64 ns;
+        glGetQueryObjectui64v(due[z].query, GL_QUERY_RESULT, &ns);
+        profiler_record(PROFILE_ZONE_GPU_WORLD + z, GPU_THREAD, due[z].issued, ns * 1e-9);
+    }
+
+    for (;;) {
+        profile_event *e = &profiler.ring[profiler.tail & (PROFILER_RING_CAP - 1)];
+        if (atomic_load_explicit(&e->sequence, memory_order_acquire) != profiler.tail + 1) break;
+        profiler_record(e->zone, e->thread, e->start, e->duration);
+        atomic_store_explicit(&e->sequence, profiler.tail + PROFILER_RING_CAP, memory_order_release);
+        profiler.tail++;
+    }
+}
+
+static int compare_floats(const void *a, const void *b)
+{
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+profile_summary profiler_get_summary(profile_zone zone)
+{
+    const list_float *samples = &profiler.samples[zone];
+    profile_summary s = {0};
+    if (!profiler.enabled || samples->len == 0) return s;
+    float *sorted = malloc(samples->len * sizeof(*sorted));
+    memcpy(sorted, samples->data, samples->len * sizeof(*sorted));
+    qsort(sorted, samples->len, sizeof(*sorted), compare_floats);
+    double sum = 0;
+    for (size_t i = 0; i < samples->len; i++) {
+        sum += sorted[i];
+    }
+    s.count = samples->len;
+    s.min = sorted[0];
+    s.avg = sum / s.count;
+    s.p50 = sorted[(s.count - 1) / 2];
+    s.p99 = sorted[(s.count - 1) * 99 / 100];
+    s.max = sorted[s.count - 1];
+    free(sorted);
+    return s;
+}
+
+const char *profile_zone_name(profile_zone zone)
+{
+    return zone_names[zone];
+}
+
+void profiler_destroy(void)
+{
+    if (!profiler.enabled) return;
+    profiler_collect();
+    printf("%-14s %8s %10s %10s %10s %10s\n", "zone", "count", "min ms", "avg ms", "p99 ms", "max ms");
+    for (int z = 0; z < PROFILE_ZONES_COUNT; z++) {
+        profile_summary s = profiler_get_summary(z);
+        if (s.count == 0) continue;
+        printf("%-14s %8zu %10.3f %10.3f %10.3f %10.3f\n", zone_names[z], s.count, s.min * 1000, s.avg * 1000,
+               s.p99 * 1000, s.max * 1000);
+    }
+    size_t dropped = atomic_load(&profiler.dropped);
+    if (dropped > 0) {
+        printf("%zu events dropped, the ring was full\n", dropped);
+    }
+    if (profiler.gpu_dropped > 0) {
+        printf("%zu GPU timings dropped, the GPU was more than %d frames behind\n", profiler.gpu_dropped, 
+               PROFILER_GPU_LATENCY - 1);
+    }
+
+    if (profiler.trace != NULL) {
+        fprintf(profiler.trace, "\n]}\n");
+        fclose(profiler.trace);
+        printf("%zu events traced\n", profiler.trace_events);
+    }
+    for (int z = 0; z < PROFILE_ZONES_COUNT; z++) {
+        list_float_destroy(&profiler.samples[z]);
+    }
+    for (int f = 0; f < PROFILER_GPU_LATENCY; f++) {
+        for (int z = 0; z < GPU_ZONES_COUNT; z++) {
+            glDeleteQueries(1, &profiler.queries[f][z].query);
+        }
+    }
+    profiler.enabled = false;
+}
@@ -0,0 +1,69 @@
+/*
+ * Times zones of each frame on the CPU, from any thread, and passes of the frame on the GPU.
+ * Timings are pushed onto a lock-free ring by the threads making them, then drained once a frame by
+ * profiler_collect on the GL thread into per zone summaries, and into a Chrome trace (chrome://tracing or
+ * ui.perfetto.dev) if one was asked for.
+ * GPU passes are timed with GL_TIME_ELAPSED queries, read back just before their slot is reused
+ * PROFILER_GPU_LATENCY - 1 frames later. Results the GPU hasn't finished by then are dropped rather than waited for,
+ * so reading them never stalls. Their trace events are placed where the pass was issued on the CPU, as GPU clocks 
+ * aren't synced.
+ * Until profiler_init is called every call is a no-op, so benchmarks and tools pay a branch per zone.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "glad.h"
+
+// events the ring holds, events pushed while it's full are dropped and counted
+#define PROFILER_RING_CAP    (1 << 14)
+// frames of GPU queries kept in flight, a query's result is read PROFILER_GPU_LATENCY - 1 frames after it's issued
+#define PROFILER_GPU_LATENCY 4
+
+typedef enum profile_zone {
+    PROFILE_ZONE_FRAME,
+    PROFILE_ZONE_INPUT,
+    PROFILE_ZONE_STREAM,
+    PROFILE_ZONE_UPDATE,
+    PROFILE_ZONE_UPLOAD,
+    PROFILE_ZONE_WORLD_RENDER,
+    PROFILE_ZONE_MODEL_RENDER,
+    PROFILE_ZONE_RAY_CAST,
+    // on the workers
+    PROFILE_ZONE_MESH,
+    PROFILE_ZONE_GENERATE,
+    // GPU passes
+    PROFILE_ZONE_GPU_WORLD,
+    PROFILE_ZONE_GPU_MODEL,
+    PROFILE_ZONE_GPU_SELECTOR,
+
+    PROFILE_ZONES_COUNT,
+} profile_zone;
+
+typedef struct profile_summary {
+    size_t count;
+    // in seconds
+    double min;
+    double avg;
+    double p50;
+    double p99;
+    double max;
+} profile_summary;
+
+/*
+ * Starts profiling, writing a Chrome trace to trace_path unless it's NULL. Needs a GL context for the GPU queries.
+ * Returns false if the trace can't be opened, profiling without it.
+ */
+bool            profiler_init(const char *trace_path);
+// start time of a CPU zone, to be passed to profiler_end once it's done. Thread safe.
+double          profiler_begin(void);
+void            profiler_end(profile_zone zone, double start);
+// GPU passes can't overlap, each must end before the next begins
+void            profiler_gpu_begin(profile_zone zone);
+void            profiler_gpu_end(profile_zone zone);
+// drains the ring and reads the GPU queries that are due, once a frame on the GL thread
+void            profiler_collect(void);
+profile_summary profiler_get_summary(profile_zone zone);
+const char     *profile_zone_name(profile_zone zone);
+// prints every zone's summary, finishes the trace and frees everything
+void            profiler_destroy(void);
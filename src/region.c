@@ -0,0 +1,222 @@
+#include "region.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REGION_MAGIC   "MKRG"
+#define REGION_VERSION 1
+
+typedef struct region_header {
+    char         magic[4];
+    uint32_t     version;
+    region_entry table[REGION_CHUNKS];
+} region_header;
+
+static void region_close(region *r);
+
+HMAP_DEFINE(cpos, region, cpos_hash, cpos_eq)
+
+static cpos region_pos(cpos cp)
+{
+    // should round toward negative by using shift
+    return (cpos){cp.x >> REGION_SIDE_BITS, cp.z >> REGION_SIDE_BITS};
+}
+
+static size_t region_index(cpos cp)
+{
+    return (size_t)(cp.z & (REGION_SIDE-1)) * REGION_SIDE + (cp.x & (REGION_SIDE-1));
+}
+
+static bool write_all(int fd, const void *buf, size_t len, size_t offset)
+{
+    const uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t written = pwrite(fd, p, len, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += written;
+        len -= written;
+        offset += written;
+    }
+    return true;
+}
+
+// makes sure the whole file is mapped, as chunks may have been appended since the last mapping
+static bool region_map(region *r)
+{
+    if (r->map != NULL && r->map_size == r->file_size) return true;
+    if (r->map != NULL) munmap(r->map, r->map_size);
+    r->map = mmap(NULL, r->file_size, PROT_READ, MAP_SHARED, r->fd, 0);
+    if (r->map == MAP_FAILED) {
+        r->map = NULL;
+        r->map_size = 0;
+        return false;
+    }
+    r->map_size = r->file_size;
+    return true;
+}
+
+// rewrites the file with only the chunks still referenced by the table
+static void region_compact(region *r)
+{
+    if (!region_map(r)) return;
+    size_t tmp_path_len = strlen(r->path) + sizeof(".tmp");
+    char *tmp_path = malloc(tmp_path_len);
+    snprintf(tmp_path, tmp_path_len, "%s.tmp", r->path);
+    int fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        free(tmp_path);
+        return;
+    }
+
+    region_header header = {REGION_MAGIC, REGION_VERSION, {{0}}};
+    size_t offset = sizeof(header);
+    bool ok = true;
+    for (size_t i = 0; i < REGION_CHUNKS && ok; i++) {
+        region_entry e = r->table[i];
+        if (e.offset == 0) continue;
+        ok = write_all(fd, r->map + e.offset, e.size, offset);
+        header.table[i] = (region_entry){offset, e.size};
+        offset += e.size;
+    }
+    ok = ok && write_all(fd, &header, sizeof(header), 0);
+    close(fd);
+    if (ok && rename(tmp_path, r->path) == 0) {
+        r->garbage = 0;
+    } else {
+        unlink(tmp_path);
+    }
+    free(tmp_path);
+}
+
+static void region_close(region *r)
+{
+    if (r->garbage > r->file_size / 2) {
+        region_compact(r);
+    }
+    if (r->map != NULL) munmap(r->map, r->map_size);
+    close(r->fd);
+    free(r->path);
+}
+
+// returns NULL if the file doesn't exist and create is false, or if it isn't a valid region file
+static region *region_store_open(region_store *s, cpos rp, bool create)
+{
+    region *r = hmap_cpos_region_get(&s->regions, &rp);
+    if (r != NULL) return r;
+
+    size_t path_len = strlen(s->dir) + 64;
+    char *path = malloc(path_len);
+    snprintf(path, path_len, "%s/r.%d.%d.mkr", s->dir, rp.x, rp.z);
+    int fd = open(path, O_RDWR | (create ? O_CREAT : 0), 0644);
+    if (fd < 0) {
+        free(path);
+        return NULL;
+    }
+
+    region_header header;
+    struct stat st;
+    if (fstat(fd, &st) != 0) goto fail;
+    if (st.st_size == 0) {
+        header = (region_header){REGION_MAGIC, REGION_VERSION, {{0}}};
+        if (!write_all(fd, &header, sizeof(header), 0)) goto fail;
+        st.st_size = sizeof(header);
+    } else if ((size_t)st.st_size < sizeof(header) 
+               || pread(fd, &header, sizeof(header), 0) != sizeof(header)
+               || memcmp(header.magic, REGION_MAGIC, sizeof(header.magic)) != 0 
+               || header.version != REGION_VERSION) {
+        fprintf(stderr, "ignoring invalid region file %s\n", path);
+        goto fail;
+    }
+
+    r = hmap_cpos_region_put(&s->regions, &rp);
+    r->path = path;
+    r->fd = fd;
+    r->map = NULL;
+    r->map_size = 0;
+    r->file_size = st.st_size;
+    r->garbage = r->file_size - sizeof(header);
+    memcpy(r->table, header.table, sizeof(r->table));
+    for (size_t i = 0; i < REGION_CHUNKS; i++) {
+        r->garbage -= r->table[i].size;
+    }
+    return r;
+
+fail:
+    close(fd);
+    free(path);
+    return NULL;
+}
+
+bool region_store_init(region_store *s, const char *dir)
+{
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return false;
+    s->dir = strdup(dir);
+    hmap_cpos_region_init(&s->regions, NULL, region_close);
+    return true;
+}
+
+bool region_store_load(region_store *s, cpos cp, chunk *c)
+{
+    region *r = region_store_open(s, region_pos(cp), false);
+    if (r == NULL) return false;
+    region_entry e = r->table[region_index(cp)];
+    if (e.offset == 0) return false;
+    if ((size_t)e.offset + e.size > r->file_size || !region_map(r)) return false;
+    return chunk_deserialize(c, r->map + e.offset, e.size);
+}
+
+bool region_store_save(region_store *s, cpos cp, const chunk *c)
+{
+    region *r = region_store_open(s, region_pos(cp), true);
+    if (r == NULL) return false;
+
+    list_uint8_t buf;
+    list_uint8_t_init_custom(&buf, 1024);
+    chunk_serialize(c, &buf);
+    size_t offset = r->file_size;
+    bool ok = write_all(r->fd, buf.data, buf.len, offset);
+    if (ok) {
+        size_t index = region_index(cp);
+        region_entry *e = &r->table[index];
+        r->garbage += e->size;
+        *e = (region_entry){offset, buf.len};
+        r->file_size += buf.len;
+        ok = write_all(r->fd, e, sizeof(*e), offsetof(region_header, table) + index * sizeof(*e));
+    }
+    list_uint8_t_destroy(&buf);
+    return ok;
+}
+
+void region_store_close_far(region_store *s, cpos center, int32_t radius)
+{
+    cpos *far = malloc(s->regions.len * sizeof(*far));
+    size_t far_len = 0;
+    HMAP_ITER_BEGIN(&s->regions, e)
+        // distance from center to the nearest chunk of the region along each axis
+        int32_t min_x = e->key.x << REGION_SIDE_BITS, max_x = min_x + REGION_SIDE - 1;
+        int32_t min_z = e->key.z << REGION_SIDE_BITS, max_z = min_z + REGION_SIDE - 1;
+        int32_t dx = center.x < min_x ? min_x - center.x : center.x > max_x ? center.x - max_x : 0;
+        int32_t dz = center.z < min_z ? min_z - center.z : center.z > max_z ? center.z - max_z : 0;
+        if (dx > radius || dz > radius) {
+            far[far_len++] = e->key;
+        }
+    HMAP_ITER_END
+    for (size_t i = 0; i < far_len; i++) {
+        hmap_cpos_region_remove(&s->regions, &far[i]);
+    }
+    free(far);
+}
+
+void region_store_destroy(region_store *s)
+{
+    hmap_cpos_region_destroy(&s->regions);
+    free(s->dir);
+}
\ No newline at end of file
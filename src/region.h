@@ -0,0 +1,54 @@
+/*
+ * On disk chunk storage. Chunks are grouped into regions of REGION_SIDE x REGION_SIDE chunks, one file each.
+ * A region file starts with a header holding an offset table of every chunk in the region, followed by 
+ * the serialized chunks (see chunk_serialize) in any order. Everything is stored in native byte order.
+ * Files are read through mmap, so only the chunks actually loaded are paged in.
+ * Rewritten chunks are appended and their table entry updated in place; the space they used before is 
+ * reclaimed by compacting the file when it's closed if more than half of it is garbage.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pos.h"
+#include "chunk.h"
+#include "containers/hmap.h"
+
+#define REGION_SIDE      32
+#define REGION_SIDE_BITS 5
+#define REGION_CHUNKS    (REGION_SIDE * REGION_SIDE)
+
+typedef struct region_entry {
+    // 0 if the chunk isn't in the file
+    uint32_t offset;
+    uint32_t size;
+} region_entry;
+
+typedef struct region {
+    char         *path;
+    int          fd;
+    uint8_t      *map;
+    size_t       map_size;
+    size_t       file_size;
+    // bytes taken by chunks that have since been rewritten elsewhere
+    size_t       garbage;
+    region_entry table[REGION_CHUNKS];
+} region;
+
+HMAP_DECLARE(cpos, region)
+
+typedef struct region_store {
+    char             *dir;
+    // keyed by region position, which is the chunk position shifted by REGION_SIDE_BITS
+    hmap_cpos_region regions;
+} region_store;
+
+// creates dir if it doesn't exist
+bool region_store_init(region_store *s, const char *dir);
+// loads the chunk at cp into c, which must be initialized. Returns false if it isn't saved.
+bool region_store_load(region_store *s, cpos cp, chunk *c);
+bool region_store_save(region_store *s, cpos cp, const chunk *c);
+// closes the files of regions with no chunk within radius of center
+void region_store_close_far(region_store *s, cpos center, int32_t radius);
+void region_store_destroy(region_store *s);
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "shader_chunk.h"
+#include "../util.h"
+
+// face_brightness is indexed by dir and matches block_face_vertices
+static const char *vertex = "\
+#version 330 core\n\
+\
+layout (location = 0) in uvec2 vertex_data;\
+\
+out vec2 extern_tex_coord;\
+out vec2 extern_tile;\
+out float extern_brightness;\
+\
+uniform mat4 vp_matrix;\
+uniform vec2 tile_size;\
+uniform samplerBuffer origins;\
+\
+const float face_brightness[6] = float[6](0.8, 0.8, 0.6, 0.6, 1.0, 0.5);\
+\
+void main()\
+{\
+    uint a = vertex_data.x;\
+    vec3 pos = vec3((a >> 0u) & 31u, (a >> 5u) & 31u, (a >> 10u) & 31u);\
+    vec3 origin = texelFetch(origins, int(vertex_data.y >> 16u)).xyz;\
+    gl_Position = vp_matrix * vec4(origin + pos, 1.0);\
+    extern_tex_coord = vec2((a >> 18u) & 31u, (a >> 23u) & 31u);\
+    extern_tile = vec2(vertex_data.y & 255u, (vertex_data.y >> 8u) & 255u) * tile_size;\
+    extern_brightness = face_brightness[(a >> 15u) & 7u];\
+}";
+
+/*
+ * tex_coord counts texture repeats across the face and tile is the atlas origin of the texture,
+ * so one quad can cover several blocks. Gradients are taken before fract so mipmapping doesn't break at the seams.
+ */
+static const char *fragment = "\
+#version 330 core\n\
+\
+in vec2 extern_tex_coord;\
+in vec2 extern_tile;\
+in float extern_brightness;\
+\
+out vec4 FragColor;\
+\
+uniform sampler2D atlas;\
+uniform vec2 tile_size;\
+\
+void main()\
+{\
+    vec2 uv = extern_tile + fract(extern_tex_coord) * tile_size;\
+    vec4 pixel = textureGrad(atlas, uv, dFdx(extern_tex_coord) * tile_size, dFdy(extern_tex_coord) * tile_size);\
+    FragColor = vec4(vec3(pixel) * extern_brightness, pixel.a);\
+}";
+
+void shader_chunk_init(shader_chunk *s)
+{
+    s->program = create_linked_program(vertex, fragment);
+    s->vp_matrix_location = glGetUniformLocation(s->program, "vp_matrix");
+    s->tile_size_location = glGetUniformLocation(s->program, "tile_size");
+    // the atlas is on unit 0 and the origins of mesh_buffer on unit 1
+    glUseProgram(s->program);
+    glUniform1i(glGetUniformLocation(s->program, "origins"), 1);
+}
+
+void shader_chunk_use(shader_chunk *s)
+{
+    glUseProgram(s->program);
+}
+
+void shader_chunk_set_tile_size(shader_chunk *s, float tile_size_s, float tile_size_t)
+{
+    glUniform2f(s->tile_size_location, tile_size_s, tile_size_t);
+}
+
+void shader_chunk_set_up_attributes(void)
+{
+    GLsizei stride = sizeof(shader_chunk_vertex);
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, stride, (void *)offsetof(shader_chunk_vertex, a));
+    glEnableVertexAttribArray(0);
+}
\ No newline at end of file
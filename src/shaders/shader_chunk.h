@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../glad.h"
+
+/*
+ * Packed vertex used for chunk meshes, decoded in the vertex shader.
+ * Positions and texture coordinates are whole numbers of blocks within a section, 
+ * normal and brightness follow from the face, and the texture is a tile in the block atlas.
+ * slot picks the section's origin from the origins buffer texture, see mesh_buffer.h.
+ * a: x:5 y:5 z:5 face:3 s:5 t:5
+ * b: tile_s:8 tile_t:8 slot:16
+ */
+typedef struct shader_chunk_vertex {
+    uint32_t a;
+    uint32_t b;
+} shader_chunk_vertex;
+
+#define SHADER_CHUNK_X_SHIFT      0
+#define SHADER_CHUNK_Y_SHIFT      5
+#define SHADER_CHUNK_Z_SHIFT      10
+#define SHADER_CHUNK_FACE_SHIFT   15
+#define SHADER_CHUNK_S_SHIFT      18
+#define SHADER_CHUNK_T_SHIFT      23
+#define SHADER_CHUNK_TILE_S_SHIFT 0
+#define SHADER_CHUNK_TILE_T_SHIFT 8
+#define SHADER_CHUNK_SLOT_SHIFT   16
+#define SHADER_CHUNK_SLOT_MASK    0xffff0000u
+
+typedef struct shader_chunk {
+    GLuint program;
+    GLuint vp_matrix_location;
+    GLuint tile_size_location;
+} shader_chunk;
+
+void shader_chunk_init(shader_chunk *s);
+void shader_chunk_use(shader_chunk *s);
+void shader_chunk_set_tile_size(shader_chunk *s, float tile_size_s, float tile_size_t);
+void shader_chunk_set_up_attributes(void);
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "terrain.h"
+#include <stdlib.h>
+#include <string.h>
+#include "util.h"
+#include "block.h"
+#include "perlin/noise1234.h"
+
+OHMAP_DEFINE(cpos, terrain_heightmap, cpos_hash, cpos_eq)
+
+const char *const terrain_stage_names[TERRAIN_STAGES_COUNT] = {
+    [TERRAIN_STAGE_HEIGHTMAP] = "heightmap",
+    [TERRAIN_STAGE_SURFACE]   = "surface",
+    [TERRAIN_STAGE_CAVES]     = "caves",
+    [TERRAIN_STAGE_STORE]     = "store",
+};
+
+#define HEIGHTMAP_FREQUENCY 0.01f
+// height of the ground where the noise is 0, and how far it strays from it where the noise is 1 or -1
+#define HEIGHTMAP_BASE      50
+#define HEIGHTMAP_RELIEF    70
+// columns this much higher than a neighbour are cliffs of bare cobblestone
+#define CLIFF_HEIGHT        2
+#define DIRT_DEPTH          3
+#define CAVE_FREQUENCY      0.04f
+// noise changes faster along y, flattening caves
+#define CAVE_FREQUENCY_Y    0.08f
+#define CAVE_THRESHOLD      0.3f
+// caves stop this far below the surface, so they only open up on cliffs
+#define CAVE_ROOF           5
+
+// cave noise samples along each axis of a chunk, the last one on the next chunk's first block
+#define CAVE_SAMPLES_SIDE   (CHUNK_SIDE / TERRAIN_CAVE_STEP + 1)
+#define CAVE_SAMPLES_HEIGHT (CHUNK_HEIGHT / TERRAIN_CAVE_STEP + 1)
+
+static inline float lerp(float a, float b, float t)
+{
+    return a + (b - a) * t;
+}
+
+// bilinearly interpolates a layer of cave samples over the chunk's columns
+static void terrain_cave_layer(const float (*samples)[CAVE_SAMPLES_SIDE], float (*layer)[CHUNK_SIDE])
+{
+    for (int z = 0; z < CHUNK_SIDE; z++) {
+        int sz = z / TERRAIN_CAVE_STEP;
+        float fz = (float)(z % TERRAIN_CAVE_STEP) / TERRAIN_CAVE_STEP;
+        for (int x = 0; x < CHUNK_SIDE; x++) {
+            int sx = x / TERRAIN_CAVE_STEP;
+            float fx = (float)(x % TERRAIN_CAVE_STEP) / TERRAIN_CAVE_STEP;
+            layer[z][x] = lerp(lerp(samples[sz][sx],     samples[sz][sx + 1],     fx),
+                               lerp(samples[sz + 1][sx], samples[sz + 1][sx + 1], fx), fz);
+        }
+    }
+}
+
+void terrain_init(terrain *t)
+{
+    pthread_mutex_init(&t->lock, NULL);
+    ohmap_cpos_terrain_heightmap_init(&t->heightmaps, NULL, NULL);
+    t->stats = (terrain_stats){0};
+}
+
+// sums octaves of noise over the chunk's columns
+static void terrain_build_heightmap(terrain_heightmap *hm, cpos cp)
+{
+    enum { N = CHUNK_SIDE * CHUNK_SIDE };
+    bpos origin = cpos_to_bpos(cp);
+    float xs[N], zs[N], octave[N];
+    float sum[N] = {0};
+    float frequency = HEIGHTMAP_FREQUENCY, amplitude = 1, amplitudes = 0;
+    for (int o = 0; o < TERRAIN_OCTAVES; o++) {
+        // octaves are offset from each other, as noise is 0 on every integer point
+        for (int z = 0; z < CHUNK_SIDE; z++) {
+            for (int x = 0; x < CHUNK_SIDE; x++) {
+                xs[z * CHUNK_SIDE + x] = (origin.x + x) * frequency + o * 0.37f;
+                zs[z * CHUNK_SIDE + x] = (origin.z + z) * frequency + o * 0.71f;
+            }
+        }
+        noise2_batch(xs, zs, octave, N);
+        for (int i = 0; i < N; i++) {
+            sum[i] += octave[i] * amplitude;
+        }
+        amplitudes += amplitude;
+        frequency *= 2;
+        amplitude /= 2;
+    }
+
+    hm->max_height = 0;
+    for (int i = 0; i < N; i++) {
+        int h = HEIGHTMAP_BASE + sum[i] / amplitudes * HEIGHTMAP_RELIEF;
+        if (h < 1) h = 1;
+        if (h > CHUNK_HEIGHT - 1) h = CHUNK_HEIGHT - 1;
+        hm->heights[i / CHUNK_SIDE][i % CHUNK_SIDE] = h;
+        if (h > hm->max_height) hm->max_height = h;
+    }
+}
+
+// copies the heightmap of cp into hm, building and caching it if it isn't cached yet
+static void terrain_get_heightmap(terrain *t, cpos cp, terrain_heightmap *hm)
+{
+    pthread_mutex_lock(&t->lock);
+    terrain_heightmap *cached = ohmap_cpos_terrain_heightmap_get(&t->heightmaps, &cp);
+    if (cached != NULL) {
+        *hm = *cached;
+        t->stats.heightmap_hits++;
+    }
+    pthread_mutex_unlock(&t->lock);
+    if (cached != NULL) return;
+
+    // built outside the lock, if another thread builds it meanwhile it's built the same
+    terrain_build_heightmap(hm, cp);
+    pthread_mutex_lock(&t->lock);
+    *ohmap_cpos_terrain_heightmap_put(&t->heightmaps, &cp) = *hm;
+    t->stats.heightmaps_built++;
+    pthread_mutex_unlock(&t->lock);
+}
+
+void terrain_generate(terrain *t, chunk *c, cpos cp)
+{
+    double seconds[TERRAIN_STAGES_COUNT];
+    double start = time_seconds();
+
+    // heights of the chunk's columns padded with a border from its neighbours, so slopes can be found at its
+    // edges. Column x, z is heights[z+1][x+1], the corners are never read.
+    int heights[CHUNK_SIDE + 2][CHUNK_SIDE + 2];
+    terrain_heightmap hm;
+    for (int d = 0; d < 4; d++) {
+        terrain_get_heightmap(t, cpos_offset(cp, d), &hm);
+        for (int i = 0; i < CHUNK_SIDE; i++) {
+            switch (d) {
+            case DIR_NORTH: heights[0][i + 1]              = hm.heights[CHUNK_SIDE - 1][i]; break;
+            case DIR_SOUTH: heights[CHUNK_SIDE + 1][i + 1] = hm.heights[0][i];              break;
+            case DIR_EAST:  heights[i + 1][CHUNK_SIDE + 1] = hm.heights[i][0];              break;
+            case DIR_WEST:  heights[i + 1][0]              = hm.heights[i][CHUNK_SIDE - 1]; break;
+            default:
+                unreachable();
+            }
+        }
+    }
+    terrain_get_heightmap(t, cp, &hm);
+    for (int z = 0; z < CHUNK_SIDE; z++) {
+        for (int x = 0; x < CHUNK_SIDE; x++) {
+            heights[z + 1][x + 1] = hm.heights[z][x];
+        }
+    }
+    double now = time_seconds();
+    seconds[TERRAIN_STAGE_HEIGHTMAP] = now - start;
+    start = now;
+
+    // sections are written whole, those above the terrain are left as air
+    int secs = (hm.max_height + CHUNK_SEC_HEIGHT - 1) / CHUNK_SEC_HEIGHT;
+    uint8_t (*data)[CHUNK_SEC_HEIGHT][CHUNK_SIDE][CHUNK_SIDE] = malloc(secs * sizeof(*data));
+    memset(data, BLOCK_AIR, secs * sizeof(*data));
+    for (int z = 0; z < CHUNK_SIDE; z++) {
+        for (int x = 0; x < CHUNK_SIDE; x++) {
+            int h = heights[z + 1][x + 1];
+            int lowest = h;
+            if (heights[z][x + 1] < lowest)     lowest = heights[z][x + 1];
+            if (heights[z + 2][x + 1] < lowest) lowest = heights[z + 2][x + 1];
+            if (heights[z + 1][x] < lowest)     lowest = heights[z + 1][x];
+            if (heights[z + 1][x + 2] < lowest) lowest = heights[z + 1][x + 2];
+            // grass and dirt cover the ground, except on cliffs
+            int soil = h - lowest >= CLIFF_HEIGHT ? 0 : DIRT_DEPTH + 1;
+            for (int y = 0; y < h; y++) {
+                int depth = h - 1 - y;
+                block_type b = depth >= soil ? BLOCK_COBBLESTONE : depth == 0 ? BLOCK_GRASS : BLOCK_DIRT;
+                data[y / CHUNK_SEC_HEIGHT][y % CHUNK_SEC_HEIGHT][z][x] = b;
+            }
+        }
+    }
+    now = time_seconds();
+    seconds[TERRAIN_STAGE_SURFACE] = now - start;
+    start = now;
+
+    // noise is sampled every TERRAIN_CAVE_STEP blocks and trilinearly interpolated in between
+    bpos origin = cpos_to_bpos(cp);
+    int samples_height = (hm.max_height - CAVE_ROOF + TERRAIN_CAVE_STEP - 1) / TERRAIN_CAVE_STEP + 1;
+    float caves[CAVE_SAMPLES_HEIGHT][CAVE_SAMPLES_SIDE][CAVE_SAMPLES_SIDE];
+    for (int sy = 0; sy < samples_height; sy++) {
+        for (int sz = 0; sz < CAVE_SAMPLES_SIDE; sz++) {
+            for (int sx = 0; sx < CAVE_SAMPLES_SIDE; sx++) {
+                caves[sy][sz][sx] = noise3((origin.x + sx * TERRAIN_CAVE_STEP) * CAVE_FREQUENCY,
+                                           sy * TERRAIN_CAVE_STEP * CAVE_FREQUENCY_Y,
+                                           (origin.z + sz * TERRAIN_CAVE_STEP) * CAVE_FREQUENCY);
+            }
+        }
+    }
+    // each layer of samples is interpolated over the columns once, then only between layers for each block
+    float below[CHUNK_SIDE][CHUNK_SIDE], above[CHUNK_SIDE][CHUNK_SIDE];
+    terrain_cave_layer(caves[0], below);
+    int cave_top = hm.max_height - CAVE_ROOF;
+    for (int sy = 0; sy * TERRAIN_CAVE_STEP < cave_top; sy++) {
+        terrain_cave_layer(caves[sy + 1], above);
+        // the bottom layer is never carved, so caves don't open onto the void
+        int y_start = sy == 0 ? 1 : sy * TERRAIN_CAVE_STEP;
+        int y_end = (sy + 1) * TERRAIN_CAVE_STEP < cave_top ? (sy + 1) * TERRAIN_CAVE_STEP : cave_top;
+        for (int y = y_start; y < y_end; y++) {
+            float fy = (float)(y % TERRAIN_CAVE_STEP) / TERRAIN_CAVE_STEP;
+            for (int z = 0; z < CHUNK_SIDE; z++) {
+                for (int x = 0; x < CHUNK_SIDE; x++) {
+                    if (y < heights[z + 1][x + 1] - CAVE_ROOF && lerp(below[z][x], above[z][x], fy) > CAVE_THRESHOLD) {
+                        data[y / CHUNK_SEC_HEIGHT][y % CHUNK_SEC_HEIGHT][z][x] = BLOCK_AIR;
+                    }
+                }
+            }
+        }
+        memcpy(below, above, sizeof(below));
+    }
+    now = time_seconds();
+    seconds[TERRAIN_STAGE_CAVES] = now - start;
+    start = now;
+
+    for (int sec = 0; sec < secs; sec++) {
+        chunk_set_sec_blocks(c, sec, (const uint8_t (*)[CHUNK_SEC_SIZE])data[sec]);
+    }
+    free(data);
+    seconds[TERRAIN_STAGE_STORE] = time_seconds() - start;
+
+    pthread_mutex_lock(&t->lock);
+    t->stats.chunks++;
+    for (int s = 0; s < TERRAIN_STAGES_COUNT; s++) {
+        t->stats.seconds[s] += seconds[s];
+    }
+    pthread_mutex_unlock(&t->lock);
+}
+
+void terrain_evict_far(terrain *t, cpos center, int32_t radius)
+{
+    pthread_mutex_lock(&t->lock);
+    cpos *far = malloc(t->heightmaps.len * sizeof(*far));
+    size_t far_len = 0;
+    OHMAP_ITER_BEGIN(&t->heightmaps, e)
+        if (abs(e->key.x - center.x) > radius || abs(e->key.z - center.z) > radius) {
+            far[far_len++] = e->key;
+        }
+    OHMAP_ITER_END
+    for (size_t i = 0; i < far_len; i++) {
+        ohmap_cpos_terrain_heightmap_remove(&t->heightmaps, &far[i]);
+    }
+    free(far);
+    pthread_mutex_unlock(&t->lock);
+}
+
+terrain_stats terrain_get_stats(terrain *t)
+{
+    pthread_mutex_lock(&t->lock);
+    terrain_stats stats = t->stats;
+    pthread_mutex_unlock(&t->lock);
+    return stats;
+}
+
+void terrain_destroy(terrain *t)
+{
+    ohmap_cpos_terrain_heightmap_destroy(&t->heightmaps);
+    pthread_mutex_destroy(&t->lock);
+}
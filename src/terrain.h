@@ -0,0 +1,61 @@
+/*
+ * Generates chunks in stages: a heightmap summed from octaves of noise, then the surface layers over it, then
+ * caves carved out with 3d noise, then storing the blocks in the chunk.
+ * Heightmaps are cached per chunk, as the surface of a chunk's edge depends on its neighbours' heights.
+ * Chunks can be generated from any number of threads at once. The time spent in each stage is summed over all
+ * of them, so generation can be budgeted.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "pos.h"
+#include "chunk.h"
+#include "containers/ohmap.h"
+
+// octaves of noise summed for the heightmap, each of twice the frequency and half the amplitude of the last
+#define TERRAIN_OCTAVES 4
+// blocks between the samples of cave noise, which is interpolated in between. Must divide CHUNK_SIDE
+#define TERRAIN_CAVE_STEP 4
+
+typedef enum terrain_stage {
+    TERRAIN_STAGE_HEIGHTMAP,
+    TERRAIN_STAGE_SURFACE,
+    TERRAIN_STAGE_CAVES,
+    TERRAIN_STAGE_STORE,
+    TERRAIN_STAGES_COUNT,
+} terrain_stage;
+
+extern const char *const terrain_stage_names[TERRAIN_STAGES_COUNT];
+
+typedef struct terrain_heightmap {
+    // height of the ground of each column, in zx order. Blocks below it are solid
+    uint8_t heights[CHUNK_SIDE][CHUNK_SIDE];
+    uint8_t max_height;
+} terrain_heightmap;
+
+OHMAP_DECLARE(cpos, terrain_heightmap)
+
+typedef struct terrain_stats {
+    size_t chunks;
+    // heightmaps built, and those found in the cache
+    size_t heightmaps_built;
+    size_t heightmap_hits;
+    double seconds[TERRAIN_STAGES_COUNT];
+} terrain_stats;
+
+typedef struct terrain {
+    // guards heightmaps and stats
+    pthread_mutex_t             lock;
+    ohmap_cpos_terrain_heightmap heightmaps;
+    terrain_stats               stats;
+} terrain;
+
+void          terrain_init(terrain *t);
+// fills c, which must be empty, with the terrain at cp
+void          terrain_generate(terrain *t, chunk *c, cpos cp);
+// drops the cached heightmaps of chunks further than radius from center
+void          terrain_evict_far(terrain *t, cpos center, int32_t radius);
+terrain_stats terrain_get_stats(terrain *t);
+void          terrain_destroy(terrain *t);
@@ -0,0 +1,89 @@
+#include "workers.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include "util.h"
+
+typedef struct worker_job {
+    void       (*func)(void *arg);
+    void       *arg;
+    worker_job *next;
+} worker_job;
+
+static void *worker_main(void *arg)
+{
+    worker_pool *p = arg;
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        while (p->head == NULL && !p->stopping) {
+            pthread_cond_wait(&p->job_available, &p->lock);
+        }
+        if (p->head == NULL) break;
+
+        worker_job *job = p->head;
+        p->head = job->next;
+        if (p->head == NULL) p->tail = NULL;
+        pthread_mutex_unlock(&p->lock);
+
+        job->func(job->arg);
+        free(job);
+
+        pthread_mutex_lock(&p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+size_t worker_pool_default_thread_count(void)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 2 ? (size_t)cores - 1 : 1;
+}
+
+void worker_pool_init(worker_pool *p, size_t thread_count)
+{
+    p->thread_count = thread_count;
+    p->head = NULL;
+    p->tail = NULL;
+    p->stopping = false;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->job_available, NULL);
+    p->threads = malloc(thread_count * sizeof(*p->threads));
+    for (size_t i = 0; i < thread_count; i++) {
+        if (pthread_create(&p->threads[i], NULL, worker_main, p) != 0) {
+            panic("%s", "failed to create worker thread");
+        }
+    }
+}
+
+void worker_pool_submit(worker_pool *p, void (*func)(void *arg), void *arg)
+{
+    worker_job *job = malloc(sizeof(*job));
+    job->func = func;
+    job->arg = arg;
+    job->next = NULL;
+
+    pthread_mutex_lock(&p->lock);
+    if (p->tail == NULL) {
+        p->head = job;
+    } else {
+        p->tail->next = job;
+    }
+    p->tail = job;
+    pthread_cond_signal(&p->job_available);
+    pthread_mutex_unlock(&p->lock);
+}
+
+void worker_pool_destroy(worker_pool *p)
+{
+    pthread_mutex_lock(&p->lock);
+    p->stopping = true;
+    pthread_cond_broadcast(&p->job_available);
+    pthread_mutex_unlock(&p->lock);
+
+    for (size_t i = 0; i < p->thread_count; i++) {
+        pthread_join(p->threads[i], NULL);
+    }
+    free(p->threads);
+    pthread_cond_destroy(&p->job_available);
+    pthread_mutex_destroy(&p->lock);
+}
\ No newline at end of file
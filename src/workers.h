@@ -0,0 +1,28 @@
+/*
+ * Fixed size pool of threads running submitted jobs in FIFO order.
+ * Jobs must not touch GL; hand results back to the GL thread instead.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct worker_job worker_job;
+
+typedef struct worker_pool {
+    pthread_t       *threads;
+    size_t          thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t  job_available;
+    worker_job      *head;
+    worker_job      *tail;
+    bool            stopping;
+} worker_pool;
+
+// one less than the number of cores so the GL thread keeps one, but at least 1
+size_t worker_pool_default_thread_count(void);
+void   worker_pool_init(worker_pool *p, size_t thread_count);
+void   worker_pool_submit(worker_pool *p, void (*func)(void *arg), void *arg);
+// runs the jobs still queued, then joins the threads
+void   worker_pool_destroy(worker_pool *p);
\ No newline at end of file
@@ -1,206 +1,866 @@
-#include "world.h"
-#include <math.h>
-#include "util.h"
-#include <stdio.h>
-#include <stddef.h>
-#include "perlin/noise1234.h"
-#include "stb_image.h"
-#include "../obj/res/atlas.png.h"
-
-HMAP_DEFINE(cpos, chunk, cpos_hash, cpos_eq)
-
-void world_init(world *w)
-{
-    w->block_atlas_texture = create_texture(res_atlas_png, ARRAY_SIZE(res_atlas_png), GL_NEAREST_MIPMAP_LINEAR, &(int){4});
-    hmap_cpos_chunk_init(&w->chunks, NULL, chunk_destroy);
-    world_generate(w);
-}
-
-void world_generate(world *w)
-{
-    for (int x = 0; x < CHUNK_SIDE * CHUNKS_PER_SIDE; x++) {
-        for (int z = 0; z < CHUNK_SIDE * CHUNKS_PER_SIDE; z++) {
-            float p = (noise2(x * 0.01, z * 0.01) + 1) / 2;
-            int h = p * 100;
-            for (int y = 0; y < h; y++) {
-                world_set_block(w, (bpos){x, y, z}, BLOCK_GRASS);
-            }
-        }
-    }
-
-    HMAP_ITER_BEGIN(&w->chunks, e)
-        cpos cp = e->key;
-        cpos offsets[4] = {
-            cpos_offset(cp, DIR_NORTH),
-            cpos_offset(cp, DIR_SOUTH),
-            cpos_offset(cp, DIR_EAST), 
-            cpos_offset(cp, DIR_WEST), 
-        };
-        chunk *dir_chunks[4] = {
-            hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_NORTH]),
-            hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_SOUTH]),
-            hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_EAST]),
-            hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_WEST]),
-        };
-
-        chunk_remesh(&e->value, (const chunk * (*)[4])&dir_chunks);
-    HMAP_ITER_END
-}
-
-block_type world_get_block(const world *w, bpos pos)
-{
-    cpos ckpos = bpos_to_cpos(pos);
-    cbpos ckbpos = bpos_to_cbpos(pos);
-    chunk *c = hmap_cpos_chunk_get(&w->chunks, &ckpos);
-    if (!c) {
-        return BLOCK_AIR;
-    }
-
-    return chunk_get_block(c, ckbpos);
-}
-
-void world_set_block(world *w, bpos pos, block_type b)
-{
-    cpos ckpos = bpos_to_cpos(pos);
-    cbpos ckbpos = bpos_to_cbpos(pos);
-    chunk *c = hmap_cpos_chunk_get(&w->chunks, &ckpos);
-    if (!c) {
-        c = hmap_cpos_chunk_put(&w->chunks, &ckpos);
-        chunk_init(c);
-    }
-
-    chunk_set_block(c, ckbpos, b);
-}
-
-#if 0
-void world_setr_block(world *w, bpos pos, block_type b) 
-{
-    cpos cp = bpos_to_cpos(pos);
-    cbpos cbp = bpos_to_cbpos(pos);
-    chunk *c = hmap_cpos_chunk_get(&w->chunks, &cp);
-    if (!c) {
-        c = hmap_cpos_chunk_put(&w->chunks, &cp);
-        chunk_init(c);
-    }
-    uint8_t affected = chunk_setr_block(c, cbp, b, );
-
-    for (dir d = DIR_NORTH; dir <= DIR_WEST; dir++) {
-        if ((affected & (1 << d)) != 0) {
-            cpos cp2 = cpos_offset(cp, d);
-            cpos offsets[4] = {
-                cpos_offset(cp2, DIR_NORTH),
-                cpos_offset(cp2, DIR_SOUTH),
-                cpos_offset(cp2, DIR_EAST), 
-                cpos_offset(cp2, DIR_WEST), 
-            };
-            chunk *dir_chunks[4] = {
-                hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_NORTH]),
-                hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_SOUTH]),
-                hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_EAST]),
-                hmap_cpos_chunk_get(&w->chunks, &offsets[DIR_WEST]),
-            };
-
-            chunk_remesh_sec(&e->value, section_from_cbpos(cbp), (const chunk *(*)[4])&dir_chunks);
-            chunk_remesh(&e->value, (const chunk * (*)[4])&dir_chunks);
-        }
-    }
-}
-#endif
-
-void world_render(const world *w, const camera *camera, shader_block *shader)
-{
-    glEnable(GL_CULL_FACE);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, w->block_atlas_texture);
-    HMAP_ITER_BEGIN(&w->chunks, e)
-        chunk_render(&e->value, e->key, camera, shader);
-    HMAP_ITER_END
-}
-
-ubpos world_ray_cast(const world *w, const camera *camera, uint8_t max_distance, block_type *block)
-{
-    // Algorithm: A Fast Voxel Traversal Algorithm for Ray Tracing
-    // https://www.researchgate.net/publication/2611491_A_Fast_Voxel_Traversal_Algorithm_for_Ray_Tracing
-    float   pos_x        = camera->pos.x;
-    float   pos_y        = camera->pos.y;
-    float   pos_z        = camera->pos.z;
-    float   dir_x        = camera->dir.x;
-    float   dir_y        = camera->dir.y;
-    float   dir_z        = camera->dir.z;
-    // ray equation is r = pos + t*dir
-    int32_t x            = (int32_t)floorf(pos_x);
-    int32_t y            = (int32_t)floorf(pos_y);
-    int32_t z            = (int32_t)floorf(pos_z);
-    int     step_x       = dir_x > 0 ? 1 : -1;
-    int     step_y       = dir_y > 0 ? 1 : -1;
-    int     step_z       = dir_z > 0 ? 1 : -1;
-
-    block_type b = world_get_block(w, (bpos){x, y, z});
-    if (block_is_opaque(b)) {
-        *block = b;
-        return (ubpos){x, y, z};
-    }
-
-    // If pos is an integer, floor or ceil wouldn't work, so we manually sub or add 1 to r respectively.
-    // But for negative dirs, this r is now about before block (we are not looking at the block at pos anymore). 
-    // So we need to go to that block as well
-    #define set_r(r, step, pos, coord) \
-    if (step > 0) {\
-        r = ceilf(pos);\
-        if (r == pos) r += 1;\
-    }\
-    else {\
-        r = floorf(pos);\
-        if (r == pos) {r -= 1; coord -= 1;}\
-    }
-    float   r_x;
-    set_r(r_x, step_x, pos_x, x);
-    float   r_y;
-    set_r(r_y, step_y, pos_y, y);
-    float   r_z;
-    set_r(r_z, step_z, pos_z, z);
-    #undef set_r
-
-    #define dir_zero(dir) dir == 0.0f || dir == -0.0f
-    // we know r, pos and dir for each axis, so we can find t for each axis
-    // t = (r-pos)/dir
-    float   t_boundary_x = dir_zero(dir_x) ? INFINITY : (r_x - pos_x) / dir_x;
-    float   t_boundary_y = dir_zero(dir_y) ? INFINITY : (r_y - pos_y) / dir_y;
-    float   t_boundary_z = dir_zero(dir_z) ? INFINITY : (r_z - pos_z) / dir_z;
-
-    // same thing, now r is step + pos
-    float   t_delta_x    = dir_zero(dir_x) ? INFINITY : step_x / dir_x;
-    float   t_delta_y    = dir_zero(dir_y) ? INFINITY : step_y / dir_y;
-    float   t_delta_z    = dir_zero(dir_z) ? INFINITY : step_z / dir_z;
-    #undef dir_zero
-
-    #define do_step_x() x += step_x; t_boundary_x += t_delta_x
-    #define do_step_y() y += step_y; t_boundary_y += t_delta_y
-    #define do_step_z() z += step_z; t_boundary_z += t_delta_z
-
-    vec3       dist;
-    float      max_distance_sq = max_distance * max_distance;
-    do {
-        if (t_boundary_x < t_boundary_z) {
-            if (t_boundary_x < t_boundary_y) {
-                do_step_x();
-            } else {
-                do_step_y();
-            }
-        } else {
-            if (t_boundary_z < t_boundary_y) {
-                do_step_z();
-            } else {
-                do_step_y();
-            }
-        }
-        b = y < 0 || y > (CHUNK_HEIGHT-1) ? BLOCK_AIR : world_get_block(w, (bpos){x, y, z});
-        vec3_sub(&dist, &(vec3){x, y, z}, &camera->pos);
-    } while (!block_is_opaque(b) && vec3_len_squared(&dist) < max_distance_sq);
-    *block = b;
-    return (ubpos){x, y, z};
-
-    #undef do_step_x
-    #undef do_step_y
-    #undef do_step_z
+#include "world.h"
+#include <math.h>
+#include "util.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "stb_image.h"
+#include "../obj/res/atlas.png.h"
+
+HMAP_DEFINE(cpos, chunk_ptr, cpos_hash, cpos_eq)
+OHMAP_DEFINE(cpos, chunk_ptr, cpos_hash, cpos_eq)
+OHMAP_DEFINE(cpos, uint16_t, cpos_hash, cpos_eq)
+
+LIST_DECLARE(cpos)
+LIST_DEFINE(cpos)
+LIST_DEFINE(uint64_t)
+LIST_DEFINE(sec_visit)
+LIST_DEFINE(chunk_ptr)
+
+typedef struct mesh_job {
+    world              *world;
+    cpos               cpos;
+    int                sec;
+    uint32_t           mesh_version;
+    chunk_mesher       mesher;
+    // whether to work out which faces see each other, only needed for cave culling
+    bool               sees;
+    chunk_sec_snapshot snap;
+    chunk_mesh         mesh;
+    mesh_job           *next;
+} mesh_job;
+
+typedef struct gen_job {
+    world   *world;
+    cpos    cpos;
+    chunk   *chunk;
+    gen_job *next;
+} gen_job;
+
+static void chunk_free(chunk_ptr *c)
+{
+    chunk_destroy(*c);
+    free(*c);
+}
+
+static chunk *world_get_chunk(const world *w, cpos cp)
+{
+    chunk_ptr *c = hmap_cpos_chunk_ptr_get(&w->chunks, &cp);
+    return c == NULL ? NULL : *c;
+}
+
+static int32_t cpos_distance(cpos a, cpos b)
+{
+    int32_t dx = abs(a.x - b.x);
+    int32_t dz = abs(a.z - b.z);
+    return dx > dz ? dx : dz;
+}
+
+// index of cp's column in visit_columns, or -1 if it's past the evict radius
+static ptrdiff_t world_column_index(const world *w, cpos cp)
+{
+    int32_t r = w->load_radius + EVICT_MARGIN;
+    if (cpos_distance(cp, w->stream_center) > r) return -1;
+    return (ptrdiff_t)(cp.z - w->stream_center.z + r) * (2 * r + 1) + cp.x - w->stream_center.x + r;
+}
+
+// refills visit_columns around the stream center, once it or the load radius changed
+static void world_fill_columns(world *w)
+{
+    int32_t r = w->load_radius + EVICT_MARGIN;
+    list_chunk_ptr_clear(&w->visit_columns);
+    for (int32_t z = w->stream_center.z - r; z <= w->stream_center.z + r; z++) {
+        for (int32_t x = w->stream_center.x - r; x <= w->stream_center.x + r; x++) {
+            *list_chunk_ptr_add(&w->visit_columns) = world_get_chunk(w, (cpos){x, z});
+        }
+    }
+}
+
+static void world_add_chunk(world *w, cpos cp, chunk *c)
+{
+    *hmap_cpos_chunk_ptr_put(&w->chunks, &cp) = c;
+    ptrdiff_t i = world_column_index(w, cp);
+    if (i >= 0) w->visit_columns.data[i] = c;
+}
+
+static void world_remove_chunk(world *w, cpos cp)
+{
+    hmap_cpos_chunk_ptr_remove(&w->chunks, &cp);
+    ptrdiff_t i = world_column_index(w, cp);
+    if (i >= 0) w->visit_columns.data[i] = NULL;
+}
+
+// cp must not be loaded yet
+static chunk *world_put_chunk(world *w, cpos cp)
+{
+    chunk *c = malloc(sizeof(*c));
+    chunk_init(c);
+    world_add_chunk(w, cp, c);
+    return c;
+}
+
+void world_init(world *w)
+{
+    w->block_atlas_texture = create_texture(res_atlas_png, ARRAY_SIZE(res_atlas_png), GL_NEAREST_MIPMAP_LINEAR, &(int){4});
+    hmap_cpos_chunk_ptr_init(&w->chunks, NULL, chunk_free);
+    mesh_buffer_init(&w->meshes);
+    AABB_soa_init(&w->cull_bounds);
+    list_mesh_alloc_ptr_init(&w->cull_meshes);
+    list_uint64_t_init(&w->cull_visible);
+    w->cave_culling = false;
+    w->render_frame = 0;
+    list_sec_visit_init(&w->visits);
+    list_chunk_ptr_init(&w->visit_columns);
+    worker_pool_init(&w->workers, worker_pool_default_thread_count());
+    pthread_mutex_init(&w->meshed_lock, NULL);
+    w->meshed = NULL;
+    pthread_mutex_init(&w->generated_lock, NULL);
+    pthread_cond_init(&w->generated_cond, NULL);
+    w->generated = NULL;
+    // the jobs free their chunks if they're not wanted anymore
+    ohmap_cpos_chunk_ptr_init(&w->generating, NULL, NULL);
+    terrain_init(&w->terrain);
+    ohmap_cpos_uint16_t_init(&w->dirty_secs, NULL, NULL);
+    w->meshes_pending = 0;
+    w->mesh_version_counter = 0;
+    w->stream_center = (cpos){0, 0};
+    w->load_radius = VIEW_DISTANCE;
+    w->stream_complete = false;
+    w->persistent = false;
+    world_fill_columns(w);
+}
+
+bool world_open_save(world *w, const char *dir)
+{
+    w->persistent = region_store_init(&w->regions, dir);
+    return w->persistent;
+}
+
+static void world_save_chunk(world *w, cpos cp, chunk *c)
+{
+    if (!c->dirty) return;
+    if (region_store_save(&w->regions, cp, c)) {
+        c->dirty = false;
+    } else {
+        fprintf(stderr, "failed to save chunk %d, %d\n", cp.x, cp.z);
+    }
+}
+
+void world_save(world *w)
+{
+    if (!w->persistent) return;
+    HMAP_ITER_BEGIN(&w->chunks, e)
+        world_save_chunk(w, e->key, e->value);
+    HMAP_ITER_END
+}
+
+static void world_get_dir_chunks(const world *w, cpos cp, const chunk *(*dir_chunks)[4])
+{
+    cpos offsets[4] = {
+        cpos_offset(cp, DIR_NORTH),
+        cpos_offset(cp, DIR_SOUTH),
+        cpos_offset(cp, DIR_EAST), 
+        cpos_offset(cp, DIR_WEST), 
+    };
+    for (dir d = DIR_NORTH; d <= DIR_WEST; d++) {
+        (*dir_chunks)[d] = world_get_chunk(w, offsets[d]);
+    }
+}
+
+// runs on a worker
+static void mesh_job_run(void *arg)
+{
+    mesh_job *job = arg;
+    double start = profiler_begin();
+    chunk_mesh_init(&job->mesh);
+    chunk_mesh_build(&job->mesh, &job->snap, job->mesher, job->sees);
+    profiler_end(PROFILE_ZONE_MESH, start);
+
+    world *w = job->world;
+    pthread_mutex_lock(&w->meshed_lock);
+    job->next = w->meshed;
+    w->meshed = job;
+    pthread_mutex_unlock(&w->meshed_lock);
+}
+
+static void world_queue_remesh_sec(world *w, cpos cp, chunk *c, int sec)
+{
+    chunk_sec *cs = &c->secs[sec];
+    cs->mesh_version = ++w->mesh_version_counter;
+    if (cs->block_count == 0) {
+        chunk_release_sec_mesh(c, sec, &w->meshes);
+        return;
+    }
+
+    const chunk *dir_chunks[4];
+    world_get_dir_chunks(w, cp, &dir_chunks);
+    mesh_job *job = malloc(sizeof(*job));
+    job->world = w;
+    job->cpos = cp;
+    job->sec = sec;
+    job->mesh_version = cs->mesh_version;
+    job->mesher = chunk_get_mesher();
+    job->sees = w->cave_culling;
+    chunk_snapshot_sec(c, sec, &dir_chunks, &job->snap);
+    w->meshes_pending++;
+    worker_pool_submit(&w->workers, mesh_job_run, job);
+}
+
+static mesh_job *world_take_meshed(world *w)
+{
+    pthread_mutex_lock(&w->meshed_lock);
+    mesh_job *job = w->meshed;
+    w->meshed = NULL;
+    pthread_mutex_unlock(&w->meshed_lock);
+    return job;
+}
+
+static void world_process_meshed(world *w, bool upload)
+{
+    mesh_job *job = world_take_meshed(w);
+    while (job != NULL) {
+        mesh_job *next = job->next;
+        chunk *c = world_get_chunk(w, job->cpos);
+        // the section may have changed or been remeshed again since the snapshot
+        if (upload && c != NULL && c->secs[job->sec].mesh_version == job->mesh_version) {
+            chunk_upload_sec(c, job->cpos, job->sec, &job->mesh, &w->meshes);
+        }
+        chunk_mesh_destroy(&job->mesh);
+        free(job);
+        w->meshes_pending--;
+        job = next;
+    }
+}
+
+void world_upload_meshes(world *w)
+{
+    world_process_meshed(w, true);
+    mesh_buffer_defragment(&w->meshes);
+}
+
+static void world_queue_remesh_chunk(world *w, cpos cp, chunk *c)
+{
+    for (int section = 0; section < CHUNK_SEC_COUNT; section++) {
+        world_queue_remesh_sec(w, cp, c, section);
+    }
+}
+
+// meshes the chunk for the first time if all its neighbours are loaded
+static void world_try_mesh_chunk(world *w, cpos cp)
+{
+    chunk *c = world_get_chunk(w, cp);
+    if (c == NULL || c->meshed) return;
+    const chunk *dir_chunks[4];
+    world_get_dir_chunks(w, cp, &dir_chunks);
+    for (dir d = DIR_NORTH; d <= DIR_WEST; d++) {
+        if (dir_chunks[d] == NULL) return;
+    }
+    c->meshed = true;
+    world_queue_remesh_chunk(w, cp, c);
+}
+
+// meshes the chunk and the neighbours it completes
+static void world_mesh_new_chunk(world *w, cpos cp)
+{
+    world_try_mesh_chunk(w, cp);
+    for (dir d = DIR_NORTH; d <= DIR_WEST; d++) {
+        world_try_mesh_chunk(w, cpos_offset(cp, d));
+    }
+}
+
+chunk *world_generate_chunk(world *w, cpos cp)
+{
+    chunk *c = world_put_chunk(w, cp);
+    terrain_generate(&w->terrain, c, cp);
+    world_mesh_new_chunk(w, cp);
+    return c;
+}
+
+// runs on a worker
+static void gen_job_run(void *arg)
+{
+    gen_job *job = arg;
+    world *w = job->world;
+    double start = profiler_begin();
+    terrain_generate(&w->terrain, job->chunk, job->cpos);
+    profiler_end(PROFILE_ZONE_GENERATE, start);
+
+    pthread_mutex_lock(&w->generated_lock);
+    job->next = w->generated;
+    w->generated = job;
+    pthread_cond_signal(&w->generated_cond);
+    pthread_mutex_unlock(&w->generated_lock);
+}
+
+static void world_queue_generate(world *w, cpos cp)
+{
+    gen_job *job = malloc(sizeof(*job));
+    job->world = w;
+    job->cpos = cp;
+    job->chunk = malloc(sizeof(*job->chunk));
+    chunk_init(job->chunk);
+    *ohmap_cpos_chunk_ptr_put(&w->generating, &cp) = job->chunk;
+    worker_pool_submit(&w->workers, gen_job_run, job);
+}
+
+// takes the generated chunks, waiting for at least one if wait is set
+static gen_job *world_take_generated(world *w, bool wait)
+{
+    pthread_mutex_lock(&w->generated_lock);
+    while (wait && w->generated == NULL) {
+        pthread_cond_wait(&w->generated_cond, &w->generated_lock);
+    }
+    gen_job *job = w->generated;
+    w->generated = NULL;
+    pthread_mutex_unlock(&w->generated_lock);
+    return job;
+}
+
+/*
+ * Adds the generated chunks to the world if keep is set, and meshes them. Chunks loaded some other way 
+ * since they were queued, or evicted by the stream center moving on, are dropped.
+ */
+static void world_process_generated(world *w, bool keep, bool wait)
+{
+    gen_job *job = world_take_generated(w, wait);
+    while (job != NULL) {
+        gen_job *next = job->next;
+        ohmap_cpos_chunk_ptr_remove(&w->generating, &job->cpos);
+        if (keep && world_get_chunk(w, job->cpos) == NULL && 
+            cpos_distance(job->cpos, w->stream_center) <= w->load_radius + EVICT_MARGIN) {
+            world_add_chunk(w, job->cpos, job->chunk);
+            world_mesh_new_chunk(w, job->cpos);
+        } else {
+            chunk_free(&job->chunk);
+        }
+        free(job);
+        job = next;
+    }
+}
+
+// loads the chunk from its region if it was saved, queueing it to be generated otherwise
+static void world_load_chunk(world *w, cpos cp)
+{
+    if (w->persistent) {
+        chunk *c = world_put_chunk(w, cp);
+        if (region_store_load(&w->regions, cp, c)) {
+            world_mesh_new_chunk(w, cp);
+            return;
+        }
+        world_remove_chunk(w, cp);
+    }
+    world_queue_generate(w, cp);
+}
+
+static void world_evict(world *w)
+{
+    list_cpos evicted;
+    list_cpos_init(&evicted);
+    HMAP_ITER_BEGIN(&w->chunks, e)
+        if (cpos_distance(e->key, w->stream_center) > w->load_radius + EVICT_MARGIN) {
+            *list_cpos_add(&evicted) = e->key;
+        }
+    HMAP_ITER_END
+    for (size_t i = 0; i < evicted.len; i++) {
+        chunk *c = world_get_chunk(w, evicted.data[i]);
+        if (w->persistent) {
+            world_save_chunk(w, evicted.data[i], c);
+        }
+        chunk_release_meshes(c, &w->meshes);
+        world_remove_chunk(w, evicted.data[i]);
+    }
+    list_cpos_destroy(&evicted);
+    world_fill_columns(w);
+    // heightmaps are kept a chunk further, as the edge chunks' neighbours were needed to generate them
+    terrain_evict_far(&w->terrain, w->stream_center, w->load_radius + EVICT_MARGIN + 1);
+    if (w->persistent) {
+        region_store_close_far(&w->regions, w->stream_center, w->load_radius + EVICT_MARGIN);
+    }
+}
+
+/*
+ * Loads missing chunks ring by ring outwards from the stream center. 
+ * Returns false if it ran past the deadline or filled the generation queue before covering the load radius.
+ */
+static bool world_load_rings(world *w, double deadline)
+{
+    cpos center = w->stream_center;
+    for (int32_t r = 0; r <= w->load_radius; r++) {
+        for (int32_t x = center.x - r; x <= center.x + r; x++) {
+            // only the ring's border, its inside was covered by smaller rings
+            int32_t z_step = (x == center.x - r || x == center.x + r) ? 1 : 2 * r;
+            for (int32_t z = center.z - r; z <= center.z + r; z += z_step) {
+                cpos cp = {x, z};
+                if (world_get_chunk(w, cp) != NULL || ohmap_cpos_chunk_ptr_get(&w->generating, &cp) != NULL) continue;
+                if (w->generating.len >= w->workers.thread_count * GEN_JOBS_PER_WORKER) return false;
+                world_load_chunk(w, cp);
+                if (time_seconds() > deadline) return false;
+            }
+        }
+    }
+    return true;
+}
+
+void world_generate(world *w)
+{
+    while (!world_load_rings(w, INFINITY) || w->generating.len > 0) {
+        world_process_generated(w, true, true);
+    }
+    w->stream_complete = true;
+}
+
+void world_stream(world *w, const vec3 *pos, double budget)
+{
+    cpos center = bpos_to_cpos((bpos){(int32_t)floorf(pos->x), 0, (int32_t)floorf(pos->z)});
+    if (!cpos_eq(&center, &w->stream_center)) {
+        w->stream_center = center;
+        w->stream_complete = false;
+        world_evict(w);
+    }
+    world_process_generated(w, true, false);
+    if (w->stream_complete) return;
+    w->stream_complete = world_load_rings(w, time_seconds() + budget);
+}
+
+void world_set_load_radius(world *w, int32_t load_radius)
+{
+    w->load_radius = load_radius;
+    w->stream_complete = false;
+    world_evict(w);
+}
+
+void world_remesh(world *w)
+{
+    HMAP_ITER_BEGIN(&w->chunks, e)
+        if (e->value->meshed) {
+            world_queue_remesh_chunk(w, e->key, e->value);
+        }
+    HMAP_ITER_END
+}
+
+void world_set_mesher(world *w, chunk_mesher m)
+{
+    chunk_set_mesher(m);
+    world_remesh(w);
+}
+
+world_mesh_stats world_get_mesh_stats(const world *w)
+{
+    world_mesh_stats stats = {0};
+    HMAP_ITER_BEGIN(&w->chunks, e)
+        for (int section = 0; section < CHUNK_SEC_COUNT; section++) {
+            const chunk_sec *cs = &e->value->secs[section];
+            if (cs->mesh.index_count == 0) continue;
+            stats.sections++;
+            stats.vertices += cs->mesh.vertex_count;
+        }
+    HMAP_ITER_END
+    stats.pages = w->meshes.pages.len;
+    stats.compactions = w->meshes.compactions;
+    stats.indices = stats.vertices / BLOCK_FACE_VERTICES_COUNT * BLOCK_FACE_INDICES_COUNT;
+    stats.vertex_bytes = stats.vertices * sizeof(shader_chunk_vertex);
+    return stats;
+}
+
+world_storage_stats world_get_storage_stats(const world *w)
+{
+    world_storage_stats stats = {0};
+    HMAP_ITER_BEGIN(&w->chunks, e)
+        stats.chunks++;
+        stats.block_bytes += chunk_block_storage_size(e->value);
+    HMAP_ITER_END
+    stats.raw_block_bytes = stats.chunks * CHUNK_SIZE;
+    return stats;
+}
+
+uint64_t world_checksum(const world *w)
+{
+    uint64_t sum = 0;
+    list_uint8_t buf;
+    list_uint8_t_init(&buf);
+    HMAP_ITER_BEGIN(&w->chunks, e)
+        list_uint8_t_clear(&buf);
+        chunk_serialize(e->value, &buf);
+        // FNV-1a of the chunk's position and blocks, summed so the order chunks are visited in doesn't matter
+        uint64_t hash = 14695981039346656037ull;
+        hash = (hash ^ (uint32_t)e->key.x) * 1099511628211ull;
+        hash = (hash ^ (uint32_t)e->key.z) * 1099511628211ull;
+        for (size_t i = 0; i < buf.len; i++) {
+            hash = (hash ^ buf.data[i]) * 1099511628211ull;
+        }
+        sum += hash;
+    HMAP_ITER_END
+    list_uint8_t_destroy(&buf);
+    return sum;
+}
+
+block_type world_get_block(const world *w, bpos pos)
+{
+    cpos ckpos = bpos_to_cpos(pos);
+    cbpos ckbpos = bpos_to_cbpos(pos);
+    chunk *c = world_get_chunk(w, ckpos);
+    if (!c) {
+        return BLOCK_AIR;
+    }
+
+    return chunk_get_block(c, ckbpos);
+}
+
+void world_set_block(world *w, bpos pos, block_type b)
+{
+    cpos ckpos = bpos_to_cpos(pos);
+    cbpos ckbpos = bpos_to_cbpos(pos);
+    chunk *c = world_get_chunk(w, ckpos);
+    if (!c) {
+        c = world_put_chunk(w, ckpos);
+    }
+
+    chunk_set_block(c, ckbpos, b);
+}
+
+void world_fill_column(world *w, int32_t x, int32_t z, int32_t y_start, int32_t y_end, block_type b)
+{
+    bpos pos = {x, 0, z};
+    cpos ckpos = bpos_to_cpos(pos);
+    cbpos ckbpos = bpos_to_cbpos(pos);
+    chunk *c = world_get_chunk(w, ckpos);
+    if (!c) {
+        c = world_put_chunk(w, ckpos);
+    }
+
+    chunk_fill_column(c, ckbpos.x, ckbpos.z, y_start < 0 ? 0 : y_start, y_end > CHUNK_HEIGHT ? CHUNK_HEIGHT : y_end, b);
+}
+
+static void world_mark_dirty(world *w, cpos cp, int sec)
+{
+    if (sec < 0 || sec >= CHUNK_SEC_COUNT) return;
+    chunk *c = world_get_chunk(w, cp);
+    // unmeshed chunks are meshed whole once their neighbours load
+    if (c == NULL || !c->meshed) return;
+    uint16_t *secs = ohmap_cpos_uint16_t_get(&w->dirty_secs, &cp);
+    if (secs == NULL) {
+        secs = ohmap_cpos_uint16_t_put(&w->dirty_secs, &cp);
+        *secs = 0;
+    }
+    *secs |= 1 << sec;
+}
+
+bool world_setr_block(world *w, bpos pos, block_type b) 
+{
+    cpos cp = bpos_to_cpos(pos);
+    cbpos cbp = bpos_to_cbpos(pos);
+    // chunks still generating aren't loaded either. Creating one here would save a hole in place of the terrain
+    chunk *c = world_get_chunk(w, cp);
+    if (c == NULL) return false;
+    if (chunk_get_block(c, cbp) == b) return true;
+    chunk_set_block(c, cbp, b);
+
+    int sec = section_from_cbpos(cbp);
+    world_mark_dirty(w, cp, sec);
+    // blocks on a section's faces are meshed into the neighbouring sections too
+    uint8_t affected = chunk_sec_get_block_affected(cbpos_to_csbpos(cbp));
+    for (dir d = 0; d < DIRS_COUNT; d++) {
+        if ((affected & (1 << d)) == 0) continue;
+        if (d == DIR_UP || d == DIR_DOWN) {
+            world_mark_dirty(w, cp, d == DIR_UP ? sec + 1 : sec - 1);
+        } else {
+            world_mark_dirty(w, cpos_offset(cp, d), sec);
+        }
+    }
+    return true;
+}
+
+size_t world_flush_edits(world *w)
+{
+    size_t queued = 0;
+    OHMAP_ITER_BEGIN(&w->dirty_secs, e)
+        // the chunk may have been evicted since
+        chunk *c = world_get_chunk(w, e->key);
+        if (c == NULL) continue;
+        for (uint16_t secs = e->value; secs != 0; secs &= secs - 1) {
+            world_queue_remesh_sec(w, e->key, c, __builtin_ctz(secs));
+            queued++;
+        }
+    OHMAP_ITER_END
+    ohmap_cpos_uint16_t_clear(&w->dirty_secs);
+    return queued;
+}
+
+void world_destroy(world *w)
+{
+    worker_pool_destroy(&w->workers);
+    world_process_meshed(w, false);
+    pthread_mutex_destroy(&w->meshed_lock);
+    world_process_generated(w, false, false);
+    pthread_mutex_destroy(&w->generated_lock);
+    pthread_cond_destroy(&w->generated_cond);
+    ohmap_cpos_chunk_ptr_destroy(&w->generating);
+    terrain_destroy(&w->terrain);
+    if (w->persistent) {
+        world_save(w);
+        region_store_destroy(&w->regions);
+    }
+    hmap_cpos_chunk_ptr_destroy(&w->chunks);
+    mesh_buffer_destroy(&w->meshes);
+    AABB_soa_destroy(&w->cull_bounds);
+    list_mesh_alloc_ptr_destroy(&w->cull_meshes);
+    list_uint64_t_destroy(&w->cull_visible);
+    list_sec_visit_destroy(&w->visits);
+    list_chunk_ptr_destroy(&w->visit_columns);
+    ohmap_cpos_uint16_t_destroy(&w->dirty_secs);
+    glDeleteTextures(1, &w->block_atlas_texture);
+}
+
+void world_set_batched(world *w, bool batched)
+{
+    w->meshes.batched = batched;
+}
+
+void world_set_cave_culling(world *w, bool cave_culling)
+{
+    if (cave_culling == w->cave_culling) return;
+    w->cave_culling = cave_culling;
+    // sections meshed while it was off see through every face until they're remeshed
+    if (cave_culling) world_remesh(w);
+}
+
+/*
+ * Draws the chunks loaded in columns x0 <= x < x1, z0 <= z < z1, culling them together and splitting them 
+ * in 4 while they're partly in view, so columns out of view are mostly skipped a quadrant at a time.
+ * The sections of single columns partly in view are left in cull_bounds for world_cull_sections.
+ */
+static void world_render_columns(world *w, const camera *camera, int32_t x0, int32_t z0, int32_t x1, int32_t z1)
+{
+    bpos min = cpos_to_bpos((cpos){x0, z0});
+    bpos max = cpos_to_bpos((cpos){x1, z1});
+    AABB aabb = {{min.x, 0, min.z}, {max.x, CHUNK_HEIGHT, max.z}};
+    frustum_test t = AABB_test_frustum(&aabb, &camera->frustum_planes);
+    if (t == FRUSTUM_OUTSIDE) return;
+    if (t == FRUSTUM_INSIDE) {
+        for (int32_t x = x0; x < x1; x++) {
+            for (int32_t z = z0; z < z1; z++) {
+                chunk *c = world_get_chunk(w, (cpos){x, z});
+                if (c != NULL) chunk_render(c, &w->meshes);
+            }
+        }
+        return;
+    }
+    if (x1 - x0 == 1 && z1 - z0 == 1) {
+        chunk *c = world_get_chunk(w, (cpos){x0, z0});
+        if (c != NULL) chunk_add_sec_bounds(c, (cpos){x0, z0}, &w->cull_bounds, &w->cull_meshes);
+        return;
+    }
+    int32_t xm = x1 - x0 > 1 ? x0 + (x1 - x0) / 2 : x1;
+    int32_t zm = z1 - z0 > 1 ? z0 + (z1 - z0) / 2 : z1;
+    world_render_columns(w, camera, x0, z0, xm, zm);
+    if (xm < x1) world_render_columns(w, camera, xm, z0, x1, zm);
+    if (zm < z1) world_render_columns(w, camera, x0, zm, xm, z1);
+    if (xm < x1 && zm < z1) world_render_columns(w, camera, xm, zm, x1, z1);
+}
+
+// draws the sections left by world_render_columns that are in view
+static void world_cull_sections(world *w, const camera *camera)
+{
+    list_uint64_t_clear(&w->cull_visible);
+    for (size_t i = 0; i < (w->cull_bounds.len + 63) / 64; i++) {
+        list_uint64_t_add(&w->cull_visible);
+    }
+    AABB_soa_test_frustum(&w->cull_bounds, &camera->frustum_planes, w->cull_visible.data);
+    for (size_t i = 0; i < w->cull_visible.len; i++) {
+        for (uint64_t bits = w->cull_visible.data[i]; bits != 0; bits &= bits - 1) {
+            mesh_buffer_draw(&w->meshes, w->cull_meshes.data[i * 64 + __builtin_ctzll(bits)]);
+        }
+    }
+    AABB_soa_clear(&w->cull_bounds);
+    list_mesh_alloc_ptr_clear(&w->cull_meshes);
+}
+
+/*
+ * Moves each plane of the frustum by the offset of a section's p-vertex from its min corner, so a section is out 
+ * of view if its min corner is behind any of the moved planes. Sections are all the same size, so this saves picking 
+ * the p-vertex of every section the walk reaches.
+ */
+static void world_sec_planes(plane (*res)[6], const plane (*frustum)[6])
+{
+    for (int i = 0; i < 6; i++) {
+        const plane *p = &(*frustum)[i];
+        (*res)[i] = *p;
+        (*res)[i].d += (p->a >= 0 ? p->a * CHUNK_SIDE : 0) + (p->b >= 0 ? p->b * CHUNK_SEC_HEIGHT : 0) + 
+                       (p->c >= 0 ? p->c * CHUNK_SIDE : 0);
+    }
+}
+
+static bool world_sec_outside(const plane (*sec_planes)[6], bpos min)
+{
+    for (int i = 0; i < 6; i++) {
+        const plane *p = &(*sec_planes)[i];
+        if (p->a * min.x + p->b * min.y + p->c * min.z + p->d < 0) return true;
+    }
+    return false;
+}
+
+/*
+ * Draws the sections the camera could see through air, walking breadth first out from its section.
+ * A section is only left through the faces it links to the face it was entered through, in a direction not 
+ * opposite to any step taken so far, and only sections in the frustum are entered.
+ * Returns false, drawing nothing, if the camera isn't in the air of a loaded section, as then it sees through 
+ * blocks the walk can't pass.
+ */
+static bool world_render_visible(world *w, const camera *camera)
+{
+    int32_t x = (int32_t)floorf(camera->pos.x), y = (int32_t)floorf(camera->pos.y), z = (int32_t)floorf(camera->pos.z);
+    if (y < 0 || y >= CHUNK_HEIGHT || world_get_block(w, (bpos){x, y, z}) != BLOCK_AIR) return false;
+    cpos cp = bpos_to_cpos((bpos){x, 0, z});
+    ptrdiff_t column = world_column_index(w, cp);
+    if (column < 0 || w->visit_columns.data[column] == NULL) return false;
+
+    plane sec_planes[6];
+    world_sec_planes(&sec_planes, &camera->frustum_planes);
+    w->render_frame++;
+    int sec = y / CHUNK_SEC_HEIGHT;
+    chunk *c = w->visit_columns.data[column];
+    c->secs[sec].visit_frame = w->render_frame;
+    // the list doubles as the queue, it's emptied after every walk
+    *list_sec_visit_add(&w->visits) = (sec_visit){c, cp, sec, DIRS_COUNT, 0};
+    for (size_t i = 0; i < w->visits.len; i++) {
+        sec_visit v = w->visits.data[i];
+        mesh_buffer_draw(&w->meshes, &v.chunk->secs[v.sec].mesh);
+        uint8_t sees = v.from == DIRS_COUNT ? CHUNK_SEC_SEES_ALL : chunk_sec_sees(v.chunk, v.sec, v.from);
+        for (dir d = 0; d < DIRS_COUNT; d++) {
+            if (!(sees & 1 << d) || v.dirs & 1 << dir_opposite(d)) continue;
+            sec_visit next = {v.chunk, v.cpos, v.sec, dir_opposite(d), v.dirs | 1 << d};
+            if (d == DIR_UP || d == DIR_DOWN) {
+                next.sec += d == DIR_UP ? 1 : -1;
+                if (next.sec < 0 || next.sec >= CHUNK_SEC_COUNT) continue;
+            } else {
+                next.cpos = cpos_offset(v.cpos, d);
+                ptrdiff_t next_column = world_column_index(w, next.cpos);
+                if (next_column < 0) continue;
+                next.chunk = w->visit_columns.data[next_column];
+                if (next.chunk == NULL) continue;
+            }
+            chunk_sec *cs = &next.chunk->secs[next.sec];
+            if (cs->visit_frame == w->render_frame) continue;
+            cs->visit_frame = w->render_frame;
+
+            bpos origin = cpos_to_bpos(next.cpos);
+            origin.y = next.sec * CHUNK_SEC_HEIGHT;
+            if (world_sec_outside(&sec_planes, origin)) continue;
+            *list_sec_visit_add(&w->visits) = next;
+        }
+    }
+    list_sec_visit_clear(&w->visits);
+    return true;
+}
+
+void world_render(world *w, const camera *camera, shader_chunk *shader)
+{
+    glEnable(GL_CULL_FACE);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, w->block_atlas_texture);
+    shader_chunk_set_tile_size(shader, BLOCK_TEX_SIDE_S, BLOCK_TEX_SIDE_T);
+    mat4 vp_matrix;
+    mat4_mul(&vp_matrix, &camera->proj_matrix, &camera->view_matrix);
+    glUniformMatrix4fv(shader->vp_matrix_location, 1, GL_FALSE, (float *)vp_matrix.arr);
+
+    mesh_buffer_begin(&w->meshes);
+    if (w->cave_culling && world_render_visible(w, camera)) {
+        mesh_buffer_end(&w->meshes);
+        return;
+    }
+    // chunks past this are evicted as soon as the stream center moves
+    int32_t r = w->load_radius + EVICT_MARGIN;
+    cpos center = w->stream_center;
+    world_render_columns(w, camera, center.x - r, center.z - r, center.x + r + 1, center.z + r + 1);
+    world_cull_sections(w, camera);
+    mesh_buffer_end(&w->meshes);
+}
+
+ubpos world_ray_cast(const world *w, const camera *camera, uint8_t max_distance, block_type *block)
+{
+    // Algorithm: A Fast Voxel Traversal Algorithm for Ray Tracing
+    // https://www.researchgate.net/publication/2611491_A_Fast_Voxel_Traversal_Algorithm_for_Ray_Tracing
+    float   pos_x        = camera->pos.x;
+    float   pos_y        = camera->pos.y;
+    float   pos_z        = camera->pos.z;
+    float   dir_x        = camera->dir.x;
+    float   dir_y        = camera->dir.y;
+    float   dir_z        = camera->dir.z;
+    // ray equation is r = pos + t*dir
+    int32_t x            = (int32_t)floorf(pos_x);
+    int32_t y            = (int32_t)floorf(pos_y);
+    int32_t z            = (int32_t)floorf(pos_z);
+    int     step_x       = dir_x > 0 ? 1 : -1;
+    int     step_y       = dir_y > 0 ? 1 : -1;
+    int     step_z       = dir_z > 0 ? 1 : -1;
+
+    block_type b = world_get_block(w, (bpos){x, y, z});
+    if (block_is_opaque(b)) {
+        *block = b;
+        return (ubpos){x, y, z};
+    }
+
+    // If pos is an integer, floor or ceil wouldn't work, so we manually sub or add 1 to r respectively.
+    // But for negative dirs, this r is now about before block (we are not looking at the block at pos anymore). 
+    // So we need to go to that block as well
+    #define set_r(r, step, pos, coord) \
+    if (step > 0) {\
+        r = ceilf(pos);\
+        if (r == pos) r += 1;\
+    }\
+    else {\
+        r = floorf(pos);\
+        if (r == pos) {r -= 1; coord -= 1;}\
+    }
+    float   r_x;
+    set_r(r_x, step_x, pos_x, x);
+    float   r_y;
+    set_r(r_y, step_y, pos_y, y);
+    float   r_z;
+    set_r(r_z, step_z, pos_z, z);
+    #undef set_r
+
+    #define dir_zero(dir) dir == 0.0f || dir == -0.0f
+    // we know r, pos and dir for each axis, so we can find t for each axis
+    // t = (r-pos)/dir
+    float   t_boundary_x = dir_zero(dir_x) ? INFINITY : (r_x - pos_x) / dir_x;
+    float   t_boundary_y = dir_zero(dir_y) ? INFINITY : (r_y - pos_y) / dir_y;
+    float   t_boundary_z = dir_zero(dir_z) ? INFINITY : (r_z - pos_z) / dir_z;
+
+    // same thing, now r is step + pos
+    float   t_delta_x    = dir_zero(dir_x) ? INFINITY : step_x / dir_x;
+    float   t_delta_y    = dir_zero(dir_y) ? INFINITY : step_y / dir_y;
+    float   t_delta_z    = dir_zero(dir_z) ? INFINITY : step_z / dir_z;
+    #undef dir_zero
+
+    #define do_step_x() x += step_x; t_boundary_x += t_delta_x
+    #define do_step_y() y += step_y; t_boundary_y += t_delta_y
+    #define do_step_z() z += step_z; t_boundary_z += t_delta_z
+
+    vec3       dist;
+    float      max_distance_sq = max_distance * max_distance;
+    do {
+        if (t_boundary_x < t_boundary_z) {
+            if (t_boundary_x < t_boundary_y) {
+                do_step_x();
+            } else {
+                do_step_y();
+            }
+        } else {
+            if (t_boundary_z < t_boundary_y) {
+                do_step_z();
+            } else {
+                do_step_y();
+            }
+        }
+        b = y < 0 || y > (CHUNK_HEIGHT-1) ? BLOCK_AIR : world_get_block(w, (bpos){x, y, z});
+        vec3_sub(&dist, &(vec3){x, y, z}, &camera->pos);
+    } while (!block_is_opaque(b) && vec3_len_squared(&dist) < max_distance_sq);
+    *block = b;
+    return (ubpos){x, y, z};
+
+    #undef do_step_x
+    #undef do_step_y
+    #undef do_step_z
 }
\ No newline at end of file
@@ -1,31 +1,165 @@
-/*
- * World uses a right handed coordinate system.
- * North is -z.
- */
-#pragma once
-
-#include "chunk.h"
-#include "glad.h"
-#include "block.h"
-#include "containers/hmap.h"
-#include "cgmath.h"
-#include "pos.h"
-#include "camera.h"
-#include "shaders/shader_block.h"
-
-#define VIEW_DISTANCE   16
-#define CHUNKS_PER_SIDE ((VIEW_DISTANCE-1)*2 + 1)
-
-HMAP_DECLARE(cpos, chunk)
-
-typedef struct world {
-    GLuint          block_atlas_texture;
-    hmap_cpos_chunk chunks;
-} world;
-
-void       world_init(world *w);
-void       world_generate(world *w);
-block_type world_get_block(const world *w, bpos pos);
-void       world_set_block(world *w, bpos pos, block_type b);
-void       world_render(const world *w, const camera *camera, shader_block *shader);
+/*
+ * World uses a right handed coordinate system.
+ * North is -z.
+ */
+#pragma once
+
+#include "chunk.h"
+#include "glad.h"
+#include "block.h"
+#include "containers/hmap.h"
+#include "containers/ohmap.h"
+#include "cgmath.h"
+#include "pos.h"
+#include "camera.h"
+#include "shaders/shader_chunk.h"
+#include "workers.h"
+#include "region.h"
+#include "mesh_buffer.h"
+#include "terrain.h"
+#include <pthread.h>
+
+// chunks within VIEW_DISTANCE-1 of the camera are drawn; the outer ring is loaded only for meshing their edges
+#define VIEW_DISTANCE   16
+// chunks are only evicted this many chunks past the load radius, so walking along a border doesn't thrash
+#define EVICT_MARGIN    2
+// chunks queued for generation at once per worker, so the nearest ones aren't stuck behind ones the stream left
+#define GEN_JOBS_PER_WORKER 32
+
+typedef chunk *chunk_ptr;
+// chunks are held by pointer, as the workers generate them apart from the map
+HMAP_DECLARE(cpos, chunk_ptr)
+OHMAP_DECLARE(cpos, chunk_ptr)
+// a bit per section of a chunk
+OHMAP_DECLARE(cpos, uint16_t)
+
+typedef struct mesh_job mesh_job;
+typedef struct gen_job gen_job;
+
+LIST_DECLARE(uint64_t)
+
+// a section reached while walking out from the camera's section to find those it could see
+typedef struct sec_visit {
+    chunk   *chunk;
+    cpos    cpos;
+    int     sec;
+    // face it was entered through, DIRS_COUNT for the camera's section
+    dir     from;
+    // bit per direction stepped to get here
+    uint8_t dirs;
+} sec_visit;
+
+LIST_DECLARE(sec_visit)
+LIST_DECLARE(chunk_ptr)
+
+typedef struct world {
+    GLuint          block_atlas_texture;
+    hmap_cpos_chunk_ptr chunks;
+    // meshes of every section, only touched on the GL thread
+    mesh_buffer     meshes;
+    // sections of columns partly in view, culled together after walking the columns
+    AABB_soa        cull_bounds;
+    list_mesh_alloc_ptr cull_meshes;
+    // bit per section of cull_bounds, set if it's in view
+    list_uint64_t   cull_visible;
+    // draw only the sections the camera could see through air, instead of every one in the frustum
+    bool            cave_culling;
+    // bumped by every walk for visible sections, the sections it reaches are marked with it
+    uint32_t        render_frame;
+    list_sec_visit  visits;
+    // the chunk of each column within the evict radius of stream_center, row major, NULL if not loaded.
+    // Kept up to date as chunks load and unload, so the walk steps between columns without hashing
+    list_chunk_ptr  visit_columns;
+    // sections are meshed on the workers and handed back through meshed to be uploaded on the GL thread
+    worker_pool     workers;
+    pthread_mutex_t meshed_lock;
+    mesh_job        *meshed;
+    // chunks are generated on the workers too, and handed back through generated to be added to chunks
+    pthread_mutex_t generated_lock;
+    pthread_cond_t  generated_cond;
+    gen_job         *generated;
+    // chunks being generated, owned by their jobs until handed back
+    ohmap_cpos_chunk_ptr generating;
+    terrain         terrain;
+    // sections edited by world_setr_block since the last world_flush_edits
+    ohmap_cpos_uint16_t dirty_secs;
+    // remeshes requested but not uploaded yet, only touched on the GL thread
+    size_t          meshes_pending;
+    // unique across the world's lifetime, so meshes of evicted chunks can't match reloaded ones
+    uint32_t        mesh_version_counter;
+    // chunks within load_radius (chebyshev distance) of stream_center are kept loaded
+    cpos            stream_center;
+    int32_t         load_radius;
+    // set once everything within load_radius is loaded, until the center or radius changes
+    bool            stream_complete;
+    // chunks are loaded from and saved to regions if persistent, and always generated otherwise
+    bool            persistent;
+    region_store    regions;
+} world;
+
+typedef struct world_mesh_stats {
+    // sections with meshes
+    size_t sections;
+    // mesh_buffer pages holding them
+    size_t pages;
+    // times a page has been compacted
+    size_t compactions;
+    size_t vertices;
+    size_t indices;
+    size_t vertex_bytes;
+} world_mesh_stats;
+
+typedef struct world_storage_stats {
+    size_t chunks;
+    // bytes used by the palette compressed blocks
+    size_t block_bytes;
+    // bytes the same blocks would take stored as one byte each
+    size_t raw_block_bytes;
+} world_storage_stats;
+
+void       world_init(world *w);
+// makes the world persistent, saved under dir. Returns false if dir can't be created.
+bool       world_open_save(world *w, const char *dir);
+// saves every chunk changed since it was last saved or loaded
+void       world_save(world *w);
+// loads or generates every missing chunk within the load radius, waiting for the workers generating them
+void       world_generate(world *w);
+// generates the chunk on the calling thread
+chunk     *world_generate_chunk(world *w, cpos cp);
+/*
+ * Loads chunks nearest to pos first, and evicts those beyond the load radius, 
+ * spending at most budget seconds loading before returning. Chunks not saved are queued to be generated on 
+ * the workers, and added by a later call once they're done.
+ */
+void       world_stream(world *w, const vec3 *pos, double budget);
+void       world_set_load_radius(world *w, int32_t load_radius);
+// queues every section of the world for remeshing
+void       world_remesh(world *w);
+// uploads the meshes finished so far without waiting for the rest
+void       world_upload_meshes(world *w);
+// switches the mesher and remeshes the whole world with it
+void       world_set_mesher(world *w, chunk_mesher m);
+world_mesh_stats world_get_mesh_stats(const world *w);
+world_storage_stats world_get_storage_stats(const world *w);
+// hash of every loaded chunk and its blocks, to check that two runs ended in the same world
+uint64_t   world_checksum(const world *w);
+block_type world_get_block(const world *w, bpos pos);
+void       world_set_block(world *w, bpos pos, block_type b);
+/*
+ * Sets the block and marks its section, and the sections sharing a face with it, to be remeshed by the next 
+ * world_flush_edits. Any number of edits to a section cost one remesh.
+ * Returns false, ignoring the edit, if the block's chunk isn't loaded.
+ */
+bool       world_setr_block(world *w, bpos pos, block_type b);
+// queues a remesh of every section marked by world_setr_block since the last call, returning how many
+size_t     world_flush_edits(world *w);
+// sets blocks y_start <= y < y_end of the column at x, z to b
+void       world_fill_column(world *w, int32_t x, int32_t z, int32_t y_start, int32_t y_end, block_type b);
+// saves the world if persistent
+void       world_destroy(world *w);
+// draws sections with a multi draw per mesh_buffer page if batched, or a draw call each otherwise
+void       world_set_batched(world *w, bool batched);
+// turning it on remeshes the world, as which faces of a section see each other is only worked out while it's on
+void       world_set_cave_culling(world *w, bool cave_culling);
+void       world_render(world *w, const camera *camera, shader_chunk *shader);
 ubpos      world_ray_cast(const world *w, const camera *camera, uint8_t max_distance, block_type *block);
\ No newline at end of file